@@ -104,6 +104,13 @@ void app_display_show_factory_reset(void);
  ******************************************************************************/
 void app_display_show_people_count(void);
 
+/***************************************************************************//**
+ * @brief
+ *   Send the next part of the display update. Call it with the external
+ *   signals of the Bluetooth stack.
+ ******************************************************************************/
+void app_display_process_evt_external_signal(uint32_t extsignals);
+
 /** @} */
 
 #endif // APP_DISPLAY_H
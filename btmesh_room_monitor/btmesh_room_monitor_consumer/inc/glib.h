@@ -102,6 +102,10 @@ typedef struct __glib_font_t{
 
   /** Pointer to the pixel map for the font. */
   const uint16_t *data;
+
+  /** Pointer to the same pixel map in the SSD1306 page format, one byte per
+   *  column for each band of 8 rows. NULL to draw the font pixel by pixel. */
+  const uint8_t *columns;
 } glib_font_t;
 
 
@@ -329,6 +333,23 @@ glib_status_t glib_draw_circle(glib_context_t *pContext, uint8_t par_x, uint8_t
 ******************************************************************************/                         
 glib_status_t glib_update_display(void);   
 
+/**************************************************************************//**
+*  @brief
+*  Request an update of the display in the background. The changed part of
+*  the glib_frame_buffer is copied when the transfer starts, drawing can go
+*  on meanwhile. Requests made during a transfer are merged in the next one.
+******************************************************************************/
+void glib_request_update(void);
+
+/**************************************************************************//**
+*  @brief
+*  Send one page of the requested update to the display device.
+*
+*  @return
+*  Returns true while pages are left to send, call it again then.
+******************************************************************************/
+bool glib_process_update(void);
+
 /**************************************************************************//**
 *  @brief
 *  Draws a bitmap
@@ -125,6 +125,33 @@ sl_status_t ssd1306_init(void);
  *****************************************************************************/
 sl_status_t ssd1306_draw(const void *data);
 
+/**************************************************************************//**
+ * @brief
+ *   Draw a region of pages and columns to SSD1306.
+ *
+ * @param[in] data
+ *   Pointer to the pixel matrix buffer of the whole display, only the region
+ *   is sent.
+ *
+ * @param[in] first_page
+ *   First page of the region
+ *
+ * @param[in] last_page
+ *   Last page of the region
+ *
+ * @param[in] first_column
+ *   First column of the region
+ *
+ * @param[in] last_column
+ *   Last column of the region
+ *
+ * @return
+ *   SL_STATUS_OK if there are no errors.
+ *****************************************************************************/
+sl_status_t ssd1306_draw_region(const void *data,
+                                uint8_t first_page, uint8_t last_page,
+                                uint8_t first_column, uint8_t last_column);
+
 /**************************************************************************//**
  * @brief
  *   Get a handle to SSD1306.
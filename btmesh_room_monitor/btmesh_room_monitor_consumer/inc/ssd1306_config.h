@@ -38,4 +38,7 @@
 #define SSD1306_DISPLAY_WIDTH           64
 #define SSD1306_DISPLAY_HEIGHT          48
 
+// First column of the controller RAM shown on the 64 columns panel
+#define SSD1306_DISPLAY_COLUMN_OFFSET   32
+
 #endif
@@ -318,6 +318,11 @@ void sl_bt_on_event(sl_bt_msg_t *evt)
       handle_le_connection_events(evt);
       break;
 
+    case sl_bt_evt_system_external_signal_id:
+      app_display_process_evt_external_signal(
+          evt->data.evt_system_external_signal.extsignals);
+      break;
+
     default:
       break;
   }
@@ -36,6 +36,7 @@
 #include "stdio.h"
 #include "string.h"
 #include "sl_status.h"
+#include "sl_bt_api.h"
 
 #include "app_log.h"
 #include "app_assert.h"
@@ -43,6 +44,9 @@
 #include "glib.h"
 #include "app_display.h"
 
+// External signal to send the display update in the background
+#define APP_DISPLAY_REFRESH_EVENT (1<<0)
+
 static glib_context_t glib_context;
 
 /// Bluetooth address
@@ -57,6 +61,7 @@ static void app_simple_timer_display_cb(sl_simple_timer_t *handle, void *data);
 static void display_draw_people_count(char *str);
 static uint8_t display_get_center_offset(char *str);
 static void display_clear_people_page(void);
+static void display_refresh(void);
 
 /* This array is generated by LCDAssistant Tool. A image with bitmap format can
  * use this tool to convert to code.
@@ -142,7 +147,7 @@ void app_display_update_people_count(uint16_t people_count,
   glib_set_font(&glib_context, (glib_font_t *) &glib_font_6x8);
   glib_draw_string(&glib_context, (char*) devices_buffer, 50, 39);
 
-  glib_update_display();
+  display_refresh();
 }
 
 /***************************************************************************//**
@@ -167,7 +172,7 @@ void app_display_show_unprovisioned(void)
   display.first_letter = display.param_text;
   display.text_length = strlen((char*) display.param_text);
 
-  glib_update_display();
+  display_refresh();
 
   // Setup a timer for display animations
   sl_status_t sc = sl_simple_timer_start(&display.timer_handle,
@@ -189,6 +194,7 @@ void app_display_show_factory_reset(void)
   glib_clear(&glib_context);
   glib_draw_string(&glib_context, "FACTORY", 4, 15);
   glib_draw_string(&glib_context, "RESET", 12, 30);
+  // The device resets right after, the screen must be sent now
   glib_update_display();
 }
 
@@ -209,7 +215,29 @@ void app_display_show_people_count(void)
   glib_draw_line(&glib_context, 0, 35, 63, 35);
   glib_set_font(&glib_context, (glib_font_t *) &glib_font_6x8);
   glib_draw_string(&glib_context, "S-LIST:", 0, 39);
-  glib_update_display();
+  display_refresh();
+}
+
+/***************************************************************************//**
+ * Handle the external signal of the background display update.
+ ******************************************************************************/
+void app_display_process_evt_external_signal(uint32_t extsignals)
+{
+  if (extsignals & APP_DISPLAY_REFRESH_EVENT) {
+    // One page per event, so the other events are not held up
+    if (glib_process_update()) {
+      sl_bt_external_signal(APP_DISPLAY_REFRESH_EVENT);
+    }
+  }
+}
+
+/***************************************************************************//**
+ * Request a display update, it is sent in the background.
+ ******************************************************************************/
+static void display_refresh(void)
+{
+  glib_request_update();
+  sl_bt_external_signal(APP_DISPLAY_REFRESH_EVENT);
 }
 
 static void display_clear_people_page(void)
@@ -230,7 +258,7 @@ static void display_draw_people_count(char *str)
                    str,
                    display_get_center_offset(str),
                    20);
-  glib_update_display();
+  display_refresh();
 }
 
 static uint8_t display_get_center_offset(char *str)
@@ -292,5 +320,5 @@ static void app_simple_timer_display_cb(sl_simple_timer_t *handle,
   display_set_paramline_next_text(param_text_buffer);
   glib_draw_string(&glib_context, (char*) param_text_buffer, 1, 4);
   // Update display
-  glib_update_display();
+  display_refresh();
 }
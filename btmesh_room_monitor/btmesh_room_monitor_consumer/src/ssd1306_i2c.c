@@ -69,23 +69,15 @@ sl_status_t ssd1306_send_command(const void *cmd, uint8_t len)
 {
   I2C_TransferSeq_TypeDef    seq;
   I2C_TransferReturn_TypeDef ret;
-  uint8_t i2c_write_data[len];
-  uint8_t i2c_read_data[1];
-  const uint8_t *ptr = cmd;
+  uint8_t control = 0x00; // Co = 0, D/C# = 0: all the next bytes are commands
 
   seq.addr  = SSD1306_SLAVE_ADDRESS << 1;
-  seq.flags = I2C_FLAG_WRITE;
-  // Select register and data to write
-  i2c_write_data[0] = 0x00; // 0x00 for cmd, 0x40 for data
-  for (int i = 0; i < len; i++) {
-    i2c_write_data[i + 1] = ptr[i];
-  }
-
-  seq.buf[0].data = i2c_write_data;
-  seq.buf[0].len  = len + 1;
-  // Select location/length of data to be read
-  seq.buf[1].data = i2c_read_data;
-  seq.buf[1].len  = 0;
+  seq.flags = I2C_FLAG_WRITE_WRITE;
+  // The control byte, then the commands straight from the caller buffer
+  seq.buf[0].data = &control;
+  seq.buf[0].len  = 1;
+  seq.buf[1].data = (uint8_t *) cmd;
+  seq.buf[1].len  = len;
   ret = I2CSPM_Transfer(SL_I2CSPM_QWIIC_PERIPHERAL, &seq);
   if (ret != i2cTransferDone) {
     return SL_STATUS_TRANSMIT;
@@ -110,26 +102,19 @@ sl_status_t ssd1306_send_command(const void *cmd, uint8_t len)
  * @return
  *    @ref SL_STATUS_OK on success or @ref SL_STATUS_FAIL on failure
  ******************************************************************************/
-sl_status_t ssd1306_send_data(const void *data, uint8_t len)
+sl_status_t ssd1306_send_data(const void *data, uint16_t len)
 {
   I2C_TransferSeq_TypeDef    seq;
   I2C_TransferReturn_TypeDef ret;
-  uint8_t i2c_write_data[len];
-  uint8_t i2c_read_data[1];
-  const uint8_t *ptr = data;
+  uint8_t control = 0x40; // Co = 0, D/C# = 1: all the next bytes are data
 
   seq.addr  = SSD1306_SLAVE_ADDRESS << 1;
-  seq.flags = I2C_FLAG_WRITE;
-  // Select register and data to write
-  i2c_write_data[0] = 0x40; // 0x00 for cmd, 0x40 for data
-  for (int i = 0; i < len; i++) {
-    i2c_write_data[i+1] = ptr[i];
-  }
-  seq.buf[0].data = i2c_write_data;
-  seq.buf[0].len  = len + 1;
-  // Select location/length of data to be read
-  seq.buf[1].data = i2c_read_data;
-  seq.buf[1].len  = 0;
+  seq.flags = I2C_FLAG_WRITE_WRITE;
+  // The control byte, then the pixels straight from the caller buffer
+  seq.buf[0].data = &control;
+  seq.buf[0].len  = 1;
+  seq.buf[1].data = (uint8_t *) data;
+  seq.buf[1].len  = len;
   ret = I2CSPM_Transfer(SL_I2CSPM_QWIIC_PERIPHERAL, &seq);
   if (ret != i2cTransferDone) {
     return SL_STATUS_TRANSMIT;
@@ -137,4 +122,3 @@ sl_status_t ssd1306_send_data(const void *data, uint8_t len)
 
   return SL_STATUS_OK;
 }
-
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""Print the font_*_columns tables of glib_font.c from its row tables.
+
+Each glyph of a row table is one uint16_t per row from the top, the left
+column in bit 15. Each glyph of a columns table is, for each band of 8 rows
+from the top, one byte per column from the left, the top row of the band in
+bit 0: the SSD1306 page format used by glib_draw_char().
+
+Usage: python3 tools/glib_font_columns.py src/glib_font.c
+
+The output replaces the font_*_columns tables of glib_font.c, from the first
+"#ifdef GLIB_INCLUDE_FONT_6x8" after the row tables to the last "#endif"
+before the glib_font_t definitions.
+"""
+
+import re
+import sys
+
+FIRST_CHAR = 32
+
+
+def read_row_tables(path):
+    with open(path) as f:
+        text = f.read()
+    tables = {}
+    pattern = r"static const uint16_t font_(\d+)x(\d+) \[\] = \{(.*?)\};"
+    for match in re.finditer(pattern, text, re.S):
+        width, height = int(match.group(1)), int(match.group(2))
+        values = [int(v, 16) for v in re.findall(r"0x[0-9A-Fa-f]+",
+                                                 re.sub(r"//.*", "",
+                                                        match.group(3)))]
+        tables[(width, height)] = values
+    return tables
+
+
+def glyph_columns(rows, width, height):
+    columns = []
+    for band in range((height + 7) // 8):
+        for column in range(width):
+            byte = 0
+            for bit in range(min(8, height - band * 8)):
+                if rows[band * 8 + bit] & (0x8000 >> column):
+                    byte |= 1 << bit
+            columns.append(byte)
+    return columns
+
+
+def print_columns_table(width, height, values):
+    name = "%dx%d" % (width, height)
+    print("#ifdef GLIB_INCLUDE_FONT_%s" % name)
+    print("static const uint8_t font_%s_columns [] = {" % name)
+    for index in range(len(values) // height):
+        rows = values[index * height:(index + 1) * height]
+        code = FIRST_CHAR + index
+        label = "sp" if code == FIRST_CHAR else chr(code)
+        line = "".join("0x%02X, " % c
+                       for c in glyph_columns(rows, width, height))
+        if label == "\\":
+            # A backslash would continue the line comment
+            print("%s /* %s */" % (line, label))
+        else:
+            print("%s // %s" % (line, label))
+    print("};")
+    print("#endif")
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("usage: %s glib_font.c" % sys.argv[0])
+    tables = read_row_tables(sys.argv[1])
+    for i, (width, height) in enumerate(sorted(tables,
+                                               key=lambda s: s[0] * s[1])):
+        if i:
+            print()
+        print_columns_table(width, height, tables[(width, height)])
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,141 @@
+/***************************************************************************//**
+ * @file i2c_bus_arbiter.h
+ * @brief Shared I2C bus arbiter
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#ifndef I2C_BUS_ARBITER_H
+#define I2C_BUS_ARBITER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************************************************//**
+ * @addtogroup i2c_bus_arbiter
+ * @brief  Shared I2C bus arbiter.
+ * @details
+ *   The VL53L1X and the SSD1306 are on the same I2C bus. A client owns the
+ *   bus for one transfer or one burst of transfers, a pending client of
+ *   higher priority is granted the bus as soon as the owner releases it.
+ * @{
+ ******************************************************************************/
+
+/// Bus clients, in decreasing order of priority
+typedef enum {
+  I2C_BUS_CLIENT_SENSOR = 0, ///< VL53L1X ranging result readout
+  I2C_BUS_CLIENT_DISPLAY,    ///< SSD1306 frame transfers
+  I2C_BUS_CLIENT_COUNT
+} i2c_bus_client_t;
+
+/// Latency statistics of a bus client, times in sleeptimer ticks
+typedef struct {
+  uint32_t grants;      ///< Number of times the bus was granted
+  uint32_t contentions; ///< Number of requests that had to wait
+  uint32_t wait_max;    ///< Longest time from request to grant
+  uint32_t wait_total;  ///< Sum of the times from request to grant
+  uint32_t hold_max;    ///< Longest time from grant to release
+} i2c_bus_arbiter_stats_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Callback of a deferred grant, called from the context which released
+ *    the bus, interrupt context included.
+ ******************************************************************************/
+typedef void (*i2c_bus_arbiter_grant_callback_t)(void);
+
+/***************************************************************************//**
+ * @brief
+ *    Request the bus without blocking, can be called from interrupt context.
+ *
+ * @param[in] client
+ *    Requesting client.
+ *
+ * @param[in] on_grant
+ *    Called when the bus is granted later, can be NULL.
+ *
+ * @return
+ *    true if the bus is granted immediately, on_grant is not called.
+ *    false if the request is pending.
+ ******************************************************************************/
+bool i2c_bus_arbiter_request(i2c_bus_client_t client,
+                             i2c_bus_arbiter_grant_callback_t on_grant);
+
+/***************************************************************************//**
+ * @brief
+ *    Request the bus and wait in EM1 until it is granted. Must not be called
+ *    from interrupt context.
+ *
+ * @param[in] client
+ *    Requesting client.
+ ******************************************************************************/
+void i2c_bus_arbiter_acquire(i2c_bus_client_t client);
+
+/***************************************************************************//**
+ * @brief
+ *    Release the bus, the highest priority pending client is granted.
+ *
+ * @param[in] client
+ *    Owner of the bus.
+ ******************************************************************************/
+void i2c_bus_arbiter_release(i2c_bus_client_t client);
+
+/***************************************************************************//**
+ * @brief
+ *    Get the latency statistics of a client.
+ *
+ * @param[in] client
+ *    Bus client.
+ *
+ * @param[out] stats
+ *    Copy of the statistics.
+ ******************************************************************************/
+void i2c_bus_arbiter_get_stats(i2c_bus_client_t client,
+                               i2c_bus_arbiter_stats_t *stats);
+
+/***************************************************************************//**
+ * @brief
+ *    Clear the latency statistics of all clients.
+ ******************************************************************************/
+void i2c_bus_arbiter_reset_stats(void);
+
+/** @} (end group i2c_bus_arbiter) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // I2C_BUS_ARBITER_H
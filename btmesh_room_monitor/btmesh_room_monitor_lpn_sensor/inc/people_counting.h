@@ -0,0 +1,187 @@
+/***************************************************************************//**
+ * @file people_counting.h
+ * @brief People counting algorithm on two zone distance samples
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#ifndef PEOPLE_COUNTING_H
+#define PEOPLE_COUNTING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PEOPLE_COUNTING_ZONES               2    // left and right zones
+// The tuning can be overridden on the command line of an offline replay
+#ifndef PEOPLE_COUNTING_DISTANCES_SIZE
+#define PEOPLE_COUNTING_DISTANCES_SIZE      10   // nb of samples filtered
+#endif
+// Zone filter: 0 = minimum of the last samples, constant time per sample,
+// 1 = median of the last samples, time proportional to the window size
+#ifndef PEOPLE_COUNTING_FILTER_MEDIAN
+#define PEOPLE_COUNTING_FILTER_MEDIAN       0
+#endif
+
+/**
+ * People counting event
+ */
+typedef enum {
+  PEOPLE_COUNTING_EVENT_NONE,   //!< No one crossed the zones
+  PEOPLE_COUNTING_EVENT_ENTER,  //!< Someone crossed from left to right
+  PEOPLE_COUNTING_EVENT_LEAVE   //!< Someone crossed from right to left
+} people_counting_event_t;
+
+/**
+ * Rejected path through the zones
+ */
+typedef enum {
+  PEOPLE_COUNTING_REJECT_TURNED_BACK, //!< Left by the zone it came in
+  PEOPLE_COUNTING_REJECT_AMBIGUOUS,   //!< Both zones changed together
+  PEOPLE_COUNTING_REJECT_COUNT
+} people_counting_reject_t;
+
+/**
+ * Ranging sample of a zone
+ */
+typedef struct {
+  uint16_t distance;         //!< Distance in mm
+  uint16_t signal_per_spad;  //!< Return signal rate per SPAD
+  uint16_t ambient_per_spad; //!< Ambient rate per SPAD
+  bool valid;                //!< The range status is valid
+} people_counting_sample_t;
+
+/**
+ * Signal and ambient rates of an empty zone, 1/16 units
+ */
+typedef struct {
+  uint32_t signal;
+  uint32_t ambient;
+  uint8_t score;             //!< Last presence score
+  uint8_t holds;             //!< Samples held in a row
+  bool seeded;               //!< Set from the first sample
+} people_counting_baseline_t;
+
+/**
+ * Sliding window filter of the presence scores of a zone
+ */
+typedef struct {
+#if (PEOPLE_COUNTING_FILTER_MEDIAN == 1)
+  uint16_t samples[PEOPLE_COUNTING_DISTANCES_SIZE]; //!< Samples, oldest first
+  uint16_t sorted[PEOPLE_COUNTING_DISTANCES_SIZE];  //!< Samples sorted
+#else
+  // Increasing minimum candidates, the head is the minimum of the window
+  uint16_t index[PEOPLE_COUNTING_DISTANCES_SIZE];   //!< Sample number
+  uint16_t value[PEOPLE_COUNTING_DISTANCES_SIZE];   //!< Sample value
+  uint8_t head;
+  uint8_t size;
+#endif
+  uint16_t sample_count;
+} people_counting_filter_t;
+
+/**
+ * State of the counting on one pair of zones, one per sensor
+ */
+typedef struct {
+  uint16_t distance_threshold[PEOPLE_COUNTING_ZONES];
+  uint8_t path_state;
+  uint8_t zone_status[PEOPLE_COUNTING_ZONES];
+  people_counting_baseline_t baselines[PEOPLE_COUNTING_ZONES];
+  people_counting_filter_t filters[PEOPLE_COUNTING_ZONES];
+  uint16_t rejects[PEOPLE_COUNTING_REJECT_COUNT]; //!< Rejected paths by type
+} people_counting_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Reset a people counting state.
+ *
+ * @param[out] counting
+ *    Counting state
+ *
+ * @param[in] distance_threshold
+ *    Someone is in a zone below this distance
+ *
+ ******************************************************************************/
+void people_counting_init(people_counting_t *counting,
+                          uint16_t distance_threshold);
+
+/***************************************************************************//**
+ * @brief
+ *    Change the distance threshold of a zone.
+ *
+ * @param[in,out] counting
+ *    Counting state
+ *
+ * @param[in] zone
+ *    Zone, 0 for left or 1 for right
+ *
+ * @param[in] distance_threshold
+ *    Someone is in the zone below this distance
+ *
+ ******************************************************************************/
+void people_counting_set_threshold(people_counting_t *counting,
+                                   uint8_t zone,
+                                   uint16_t distance_threshold);
+
+/***************************************************************************//**
+ * @brief
+ *    Check whether nobody is in the zones.
+ *
+ * @param[in] counting
+ *    Counting state
+ *
+ * @return
+ *    true if no zone is occupied and no path is in progress
+ ******************************************************************************/
+bool people_counting_is_empty(const people_counting_t *counting);
+
+/***************************************************************************//**
+ * @brief
+ *    Add a ranging sample of a zone and detect a crossing.
+ *
+ * @param[in,out] counting
+ *    Counting state
+ *
+ * @param[in] sample
+ *    Ranging sample
+ *
+ * @param[in] zone
+ *    Zone of the sample, 0 for left or 1 for right
+ *
+ * @return
+ *    The crossing detected with this sample
+ ******************************************************************************/
+people_counting_event_t people_counting_process(
+  people_counting_t *counting,
+  const people_counting_sample_t *sample,
+  uint8_t zone);
+
+#endif // PEOPLE_COUNTING_H
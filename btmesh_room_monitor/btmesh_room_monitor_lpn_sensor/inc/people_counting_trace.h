@@ -0,0 +1,156 @@
+/***************************************************************************//**
+ * @file people_counting_trace.h
+ * @brief Delta encoded ring of people counting samples
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#ifndef PEOPLE_COUNTING_TRACE_H
+#define PEOPLE_COUNTING_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "people_counting.h"
+
+#define PEOPLE_COUNTING_TRACE_ZONES         16   // zones told apart
+#define PEOPLE_COUNTING_TRACE_RECORD_MAX    16   // longest encoded record
+
+/**
+ * Sample of the trace
+ */
+typedef struct {
+  uint32_t time_ms;                //!< Ranging time in ms
+  uint8_t zone;                    //!< Zone, below PEOPLE_COUNTING_TRACE_ZONES
+  uint8_t status;                  //!< Range status of the sensor
+  people_counting_sample_t sample; //!< Sample given to the people counting
+} people_counting_trace_record_t;
+
+/**
+ * Values the next record is encoded against
+ */
+typedef struct {
+  uint32_t time_ms;
+  uint16_t distance[PEOPLE_COUNTING_TRACE_ZONES];
+  uint16_t signal[PEOPLE_COUNTING_TRACE_ZONES];
+  uint16_t ambient[PEOPLE_COUNTING_TRACE_ZONES];
+} people_counting_trace_state_t;
+
+/**
+ * Ring of records, each one is encoded as the difference to the previous
+ * sample of its zone. The oldest records are dropped when it is full.
+ */
+typedef struct {
+  uint8_t *buffer;
+  uint16_t size;
+  uint16_t head;                       //!< Offset of the oldest record
+  uint16_t used;                       //!< Bytes in use
+  uint32_t dropped;                    //!< Records dropped when full
+  people_counting_trace_state_t first; //!< State before the oldest record
+  people_counting_trace_state_t last;  //!< State after the newest record
+} people_counting_trace_t;
+
+/**
+ * Position of a read in the ring
+ */
+typedef struct {
+  uint16_t offset;
+  uint16_t remaining;
+  people_counting_trace_state_t state;
+} people_counting_trace_cursor_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Reset a trace.
+ *
+ * @param[out] trace
+ *    Trace
+ *
+ * @param[in] buffer
+ *    Memory of the ring
+ *
+ * @param[in] size
+ *    Size of the buffer, at least PEOPLE_COUNTING_TRACE_RECORD_MAX
+ *
+ ******************************************************************************/
+void people_counting_trace_init(people_counting_trace_t *trace,
+                                uint8_t *buffer,
+                                uint16_t size);
+
+/***************************************************************************//**
+ * @brief
+ *    Add a record, dropping the oldest ones if the ring is full.
+ *
+ * @param[in,out] trace
+ *    Trace
+ *
+ * @param[in] record
+ *    Record to add
+ *
+ ******************************************************************************/
+void people_counting_trace_add(people_counting_trace_t *trace,
+                               const people_counting_trace_record_t *record);
+
+/***************************************************************************//**
+ * @brief
+ *    Start reading the records from the oldest one.
+ *
+ * @param[in] trace
+ *    Trace
+ *
+ * @param[out] cursor
+ *    Read position
+ *
+ ******************************************************************************/
+void people_counting_trace_rewind(const people_counting_trace_t *trace,
+                                  people_counting_trace_cursor_t *cursor);
+
+/***************************************************************************//**
+ * @brief
+ *    Read the next record.
+ *
+ * @param[in] trace
+ *    Trace, no record must be added while reading
+ *
+ * @param[in,out] cursor
+ *    Read position
+ *
+ * @param[out] record
+ *    Record read
+ *
+ * @return
+ *    false when all the records are read
+ ******************************************************************************/
+bool people_counting_trace_read(const people_counting_trace_t *trace,
+                                people_counting_trace_cursor_t *cursor,
+                                people_counting_trace_record_t *record);
+
+#endif // PEOPLE_COUNTING_TRACE_H
@@ -0,0 +1,118 @@
+/***************************************************************************//**
+ * @file people_flow.h
+ * @brief People flow statistics
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#ifndef PEOPLE_FLOW_H
+#define PEOPLE_FLOW_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Device property IDs of the statistics, outside of the SIG assigned ones
+#define PEOPLE_FLOW_PROPERTY_ENTRIES      0xFF01 // uint32, entries
+#define PEOPLE_FLOW_PROPERTY_EXITS        0xFF02 // uint32, exits
+#define PEOPLE_FLOW_PROPERTY_FLOW_RATE    0xFF03 // uint16, people per hour
+#define PEOPLE_FLOW_PROPERTY_PEAK_COUNT   0xFF04 // uint16, people
+
+// Size of the sensor data of all the statistics
+#define PEOPLE_FLOW_SENSOR_DATA_SIZE      (4 * 3 + 4 + 4 + 2 + 2)
+
+/**
+ * Statistics of the people through the door
+ */
+typedef struct {
+  uint32_t entries;          //!< Entries since the reset
+  uint32_t exits;            //!< Exits since the reset
+  uint16_t peak_count;       //!< Highest people count since the reset
+  uint16_t flow_rate;        //!< Entries and exits per hour, last interval
+  uint16_t interval_passes;  //!< Entries and exits of the current interval
+} people_flow_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Reset the statistics.
+ *
+ * @param[out] flow
+ *    Statistics
+ *
+ ******************************************************************************/
+void people_flow_init(people_flow_t *flow);
+
+/***************************************************************************//**
+ * @brief
+ *    Account for someone going through the door.
+ *
+ * @param[in,out] flow
+ *    Statistics
+ *
+ * @param[in] enter
+ *    true for an entry, false for an exit
+ *
+ * @param[in] count
+ *    People count after the pass
+ *
+ ******************************************************************************/
+void people_flow_add(people_flow_t *flow, bool enter, uint16_t count);
+
+/***************************************************************************//**
+ * @brief
+ *    End the current interval and update the flow rate.
+ *
+ * @param[in,out] flow
+ *    Statistics
+ *
+ * @param[in] interval_ms
+ *    Length of the interval
+ *
+ ******************************************************************************/
+void people_flow_close_interval(people_flow_t *flow, uint32_t interval_ms);
+
+/***************************************************************************//**
+ * @brief
+ *    Marshal the statistics as sensor data, property ID, length and value of
+ *    each property, little endian.
+ *
+ * @param[in] flow
+ *    Statistics
+ *
+ * @param[out] data
+ *    Buffer of at least PEOPLE_FLOW_SENSOR_DATA_SIZE bytes
+ *
+ * @return
+ *    Size of the sensor data
+ ******************************************************************************/
+uint8_t people_flow_to_sensor_data(const people_flow_t *flow, uint8_t *data);
+
+#endif // PEOPLE_FLOW_H
@@ -37,6 +37,23 @@
 #ifndef ROOM_MONITOR_APP_H
 #define ROOM_MONITOR_APP_H
 
+#include <stdint.h>
+
+// Sensor setting of the people count property which sets the count
+#define ROOM_MONITOR_PEOPLE_COUNT_SETTING_ID  0xFF10
+// Device property of the sensor health, uint8 vl53l1x_app_health_t
+#define ROOM_MONITOR_HEALTH_PROPERTY_ID       0xFF05
+
+/**
+ * Corrections of the people count
+ */
+typedef struct {
+  uint32_t zeroed;    //!< Residual counts zeroed after an empty period
+  uint32_t decayed;   //!< Uncertain counts decreased after an empty period
+  uint32_t clamped;   //!< Leaves ignored at a count of 0
+  uint32_t set_count; //!< Counts set by the application or a client
+} room_monitor_correction_stats_t;
+
 /**************************************************************************//**
  * @brief
  *   Initialization function for the room monitor module.
@@ -61,6 +78,27 @@ void room_monitor_app_start_sampling(uint16_t delay_ms);
  ******************************************************************************/
 void room_monitor_app_stop_sampling(void);
 
+/***************************************************************************//**
+ * @brief
+ *    Replace the people count, e.g. on a reset requested by a client.
+ *
+ * @param[in] count
+ *    New people count
+ *
+ ******************************************************************************/
+void room_monitor_app_set_people_count(uint16_t count);
+
+/***************************************************************************//**
+ * @brief
+ *    Get the corrections applied to the people count.
+ *
+ * @param[out] stats
+ *    Number of corrections of each kind
+ *
+ ******************************************************************************/
+void room_monitor_app_get_correction_stats(
+  room_monitor_correction_stats_t *stats);
+
 /***************************************************************************//**
  * @brief
  *    Handle bluetooth event external signal trigger by room monitor module.
@@ -89,7 +89,7 @@ sl_status_t ssd1306_send_command(const void *cmd, uint8_t len);
  * @return
  *    @ref SL_STATUS_OK on success or @ref SL_STATUS_FAIL on failure
  ******************************************************************************/
-sl_status_t ssd1306_send_data(const void *data, uint8_t len);
+sl_status_t ssd1306_send_data(const void *data, uint16_t len);
 
 #ifdef __cplusplus
 }
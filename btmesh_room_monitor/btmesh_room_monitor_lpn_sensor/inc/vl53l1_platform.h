@@ -42,13 +42,17 @@
 #define _VL53L1_PLATFORM_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "sl_status.h"
+#ifndef VL53L1X_PLATFORM_EMULATOR
 #include "sl_i2cspm.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#ifndef VL53L1X_PLATFORM_EMULATOR
 /***************************************************************************//**
  * @brief
  *    This function sets the IC2SPM instance used by platform functions.
@@ -58,6 +62,98 @@ extern "C" {
  *
  ******************************************************************************/
 void vl53l1x_platform_set_i2cspm_instance(sl_i2cspm_t *i2cspm_instance);
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Completion callback of an asynchronous transfer, called from the I2C
+ *    interrupt.
+ *
+ * @param[in] status
+ *    SL_STATUS_OK if the transfer succeeded, SL_STATUS_TRANSMIT otherwise.
+ *
+ * @param[in] context
+ *    Context pointer passed at submission.
+ *
+ ******************************************************************************/
+typedef void (*vl53l1_platform_callback_t)(sl_status_t status, void *context);
+
+/***************************************************************************//**
+ * @brief
+ *    Queue a register read. The data is written to pdata by the I2C
+ *    interrupt, pdata must stay valid until the callback is called.
+ *
+ * @param[in] dev
+ *    Device address.
+ *
+ * @param[in] index
+ *    Register index.
+ *
+ * @param[out] pdata
+ *    Destination of the read data.
+ *
+ * @param[in] count
+ *    Number of bytes to read.
+ *
+ * @param[in] callback
+ *    Completion callback, can be NULL.
+ *
+ * @param[in] context
+ *    Context pointer passed to the callback.
+ *
+ * @return
+ *    SL_STATUS_OK if the transfer is queued.
+ *    SL_STATUS_NO_MORE_RESOURCE if the queue is full.
+ ******************************************************************************/
+sl_status_t vl53l1_platform_read_async(uint16_t dev, uint16_t index,
+		uint8_t *pdata, uint32_t count, vl53l1_platform_callback_t callback,
+		void *context);
+
+/***************************************************************************//**
+ * @brief
+ *    Queue a register write. Up to 4 bytes of payload are copied to the
+ *    preallocated transfer buffer.
+ *
+ * @param[in] dev
+ *    Device address.
+ *
+ * @param[in] index
+ *    Register index.
+ *
+ * @param[in] pdata
+ *    Data to write.
+ *
+ * @param[in] count
+ *    Number of bytes to write.
+ *
+ * @param[in] callback
+ *    Completion callback, can be NULL.
+ *
+ * @param[in] context
+ *    Context pointer passed to the callback.
+ *
+ * @return
+ *    SL_STATUS_OK if the transfer is queued.
+ *    SL_STATUS_INVALID_PARAMETER if count is too large.
+ *    SL_STATUS_NO_MORE_RESOURCE if the queue is full.
+ ******************************************************************************/
+sl_status_t vl53l1_platform_write_async(uint16_t dev, uint16_t index,
+		const uint8_t *pdata, uint32_t count,
+		vl53l1_platform_callback_t callback, void *context);
+
+/***************************************************************************//**
+ * @brief
+ *    Check if there are queued or ongoing transfers.
+ *
+ ******************************************************************************/
+bool vl53l1_platform_is_busy(void);
+
+/***************************************************************************//**
+ * @brief
+ *    Wait in EM1 until all queued transfers are done.
+ *
+ ******************************************************************************/
+void vl53l1_platform_wait_idle(void);
 
 /** @brief VL53L1_ReadMulti() definition.\n
 
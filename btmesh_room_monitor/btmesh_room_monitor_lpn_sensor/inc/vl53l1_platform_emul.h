@@ -0,0 +1,236 @@
+/***************************************************************************//**
+ * @file vl53l1_platform_emul.h
+ * @brief VL53L1X register level emulator for host builds
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with the
+ * specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#ifndef VL53L1_PLATFORM_EMUL_H_
+#define VL53L1_PLATFORM_EMUL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sl_status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************************************************//**
+ * @addtogroup VL53L1X_EMUL
+ * @{
+ *
+ * @brief
+ *  Stand-in for vl53l1_platform.c on a workstation, selected by defining
+ *  VL53L1X_PLATFORM_EMULATOR. The VL53L1_WrByte() / VL53L1_RdWord() / ...
+ *  platform functions access an emulated register map instead of the I2C
+ *  bus. Ranging runs on a virtual clock: every transfer costs its bus time,
+ *  the host advances the clock for the time the MCU is idle, and each
+ *  completed ranging latches the trace sample recorded for the current ROI
+ *  center into the result registers.
+ *
+ ******************************************************************************/
+
+/** Maximum number of emulated sensors, selected by the XSHUT lines */
+#ifndef VL53L1_EMUL_MAX_DEVICES
+#define VL53L1_EMUL_MAX_DEVICES			4
+#endif
+
+/** Trace sample matching any ROI center */
+#define VL53L1_EMUL_ROI_ANY				0xFF
+
+/***************************************************************************//**
+ * @brief
+ *    Recorded ranging sample. The status is the value reported by
+ *    VL53L1X_GetRangeStatus(), rates are in kcps per SPAD.
+ ******************************************************************************/
+typedef struct {
+	uint32_t time_ms;			/*!< time since the trace start */
+	uint8_t roi_center;		/*!< ROI center SPAD or VL53L1_EMUL_ROI_ANY */
+	uint8_t status;				/*!< range status */
+	uint16_t distance;		/*!< distance in mm */
+	uint16_t signal_per_spad;	/*!< signal rate per SPAD */
+	uint16_t ambient_per_spad;	/*!< ambient rate per SPAD */
+	uint8_t spads;				/*!< number of enabled SPADs */
+} vl53l1_emul_sample_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Bus and ranging counters of the emulator.
+ ******************************************************************************/
+typedef struct {
+	uint32_t transfers;		/*!< I2C transfers, NACKed ones included */
+	uint32_t bytes;				/*!< bytes on the bus, addresses included */
+	uint64_t bus_time_us;	/*!< time spent on the bus */
+	uint32_t rangings;		/*!< completed rangings */
+	uint32_t overruns;		/*!< rangings lost while the interrupt was set */
+} vl53l1_emul_stats_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Reset the virtual clock, the counters and all emulated sensors.
+ *    Sensor 0 is powered, the other ones are held in reset by XSHUT.
+ *
+ * @param[in] bus_frequency
+ *    I2C bus frequency in Hz used for the transfer times.
+ ******************************************************************************/
+void vl53l1_emul_init(uint32_t bus_frequency);
+
+/***************************************************************************//**
+ * @brief
+ *    Drive the XSHUT line of an emulated sensor. A low level resets the
+ *    sensor, its I2C address goes back to 0x29. The sensor boots again when
+ *    the line is released.
+ *
+ * @param[in] index
+ *    Sensor index.
+ *
+ * @param[in] enable
+ *    true to release the sensor from reset.
+ *
+ * @return
+ *    SL_STATUS_INVALID_PARAMETER if the index is out of range.
+ ******************************************************************************/
+sl_status_t vl53l1_emul_set_xshut(uint8_t index, bool enable);
+
+/***************************************************************************//**
+ * @brief
+ *    Set the trace played back by a sensor. The samples must be sorted by
+ *    time, they are not copied. The trace time starts now.
+ *
+ * @param[in] index
+ *    Sensor index.
+ *
+ * @param[in] samples
+ *    Recorded samples.
+ *
+ * @param[in] count
+ *    Number of samples.
+ *
+ * @return
+ *    SL_STATUS_INVALID_PARAMETER if the index is out of range.
+ ******************************************************************************/
+sl_status_t vl53l1_emul_set_trace(uint8_t index,
+		const vl53l1_emul_sample_t *samples, size_t count);
+
+/***************************************************************************//**
+ * @brief
+ *    Load a trace from a text file and set it for a sensor. One sample per
+ *    line: time_ms,roi_center,status,distance,signal,ambient,spads.
+ *    Empty lines and lines starting with '#' are skipped.
+ *
+ * @param[in] index
+ *    Sensor index.
+ *
+ * @param[in] path
+ *    Trace file.
+ *
+ * @return
+ *    SL_STATUS_OK if the trace is loaded.
+ *    SL_STATUS_NOT_FOUND if the file can not be opened.
+ *    SL_STATUS_ALLOCATION_FAILED if the samples do not fit in memory.
+ ******************************************************************************/
+sl_status_t vl53l1_emul_load_trace(uint8_t index, const char *path);
+
+/***************************************************************************//**
+ * @brief
+ *    Advance the virtual clock, for the time the MCU sleeps or computes.
+ *
+ * @param[in] time_us
+ *    Elapsed time in microseconds.
+ ******************************************************************************/
+void vl53l1_emul_advance_us(uint32_t time_us);
+
+/***************************************************************************//**
+ * @brief
+ *    Get the virtual clock.
+ *
+ * @return
+ *    Time since vl53l1_emul_init() in microseconds.
+ ******************************************************************************/
+uint64_t vl53l1_emul_get_time_us(void);
+
+/***************************************************************************//**
+ * @brief
+ *    Get the time of the next ranging completion of a sensor, to advance
+ *    the clock up to the next data ready when the GPIO1 interrupt is
+ *    emulated by the host.
+ *
+ * @param[in] index
+ *    Sensor index.
+ *
+ * @param[out] time_us
+ *    Completion time, UINT64_MAX if the sensor is not ranging.
+ *
+ * @return
+ *    SL_STATUS_INVALID_PARAMETER if the index is out of range.
+ ******************************************************************************/
+sl_status_t vl53l1_emul_get_next_ranging_time_us(uint8_t index,
+		uint64_t *time_us);
+
+/***************************************************************************//**
+ * @brief
+ *    Get the level of the GPIO1 output of a sensor.
+ *
+ * @param[in] index
+ *    Sensor index.
+ *
+ * @return
+ *    Pin level, depending on the interrupt polarity.
+ ******************************************************************************/
+bool vl53l1_emul_get_gpio1(uint8_t index);
+
+/***************************************************************************//**
+ * @brief
+ *    Get a copy of the counters.
+ *
+ * @param[out] stats
+ *    Counters since vl53l1_emul_init() or the last reset.
+ ******************************************************************************/
+void vl53l1_emul_get_stats(vl53l1_emul_stats_t *stats);
+
+/***************************************************************************//**
+ * @brief
+ *    Clear the counters.
+ ******************************************************************************/
+void vl53l1_emul_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif /* VL53L1_PLATFORM_EMUL_H_ */
@@ -41,7 +41,9 @@
 #define VL53L1X_H_
 
 #include "sl_status.h"
+#ifndef VL53L1X_PLATFORM_EMULATOR
 #include "sl_i2cspm.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -92,6 +94,25 @@ typedef struct {
 	uint16_t number_per_spads; /*!< Result number per SPADs */
 } vl53l1x_result_t;
 
+/***************************************************************************//**
+ * @brief
+ *    Typedef for the completion callback of an asynchronous result read.
+ ******************************************************************************/
+typedef void (*vl53l1x_result_callback_t)(sl_status_t status,
+		const vl53l1x_result_t *result, void *context);
+
+/***************************************************************************//**
+ * @brief
+ *    Typedef for specifying an asynchronous result read.
+ ******************************************************************************/
+typedef struct {
+	uint16_t dev; /*!< Device address */
+	uint8_t raw[17]; /*!< Raw result block from RESULT__RANGE_STATUS */
+	vl53l1x_result_t result; /*!< Decoded result */
+	vl53l1x_result_callback_t callback; /*!< Completion callback */
+	void *context; /*!< Callback context */
+} vl53l1x_result_request_t;
+
 /***************************************************************************//**
  * @brief
  *    This function loads the 135 bytes default values to initialize the sensor.
@@ -106,6 +127,19 @@ typedef struct {
  ******************************************************************************/
 sl_status_t vl53l1x_init(uint16_t dev);
 
+/***************************************************************************//**
+ * @brief
+ *    This function drops the RAM copy of the configuration registers of the
+ *    device. The setters skip the writes of unchanged values and the getters
+ *    are served from this copy, it has to be invalidated after the registers
+ *    are written without this driver, vl53l1x_init() does it.
+ *
+ * @param[in] dev
+ *    Device address. (Default: 0x29[0x52])
+ ******************************************************************************/
+void vl53l1x_invalidate_shadow(uint16_t dev);
+
+#ifndef VL53L1X_PLATFORM_EMULATOR
 /***************************************************************************//**
  * @brief
  *    This function sets the IC2SPM instance used by platform functions.
@@ -118,6 +152,7 @@ sl_status_t vl53l1x_init(uint16_t dev);
  *    SL_STATUS_INVALID_PARAMETER if int_pol is invalid.
  ******************************************************************************/
 sl_status_t vl53l1x_set_i2cspm_instance(sl_i2cspm_t *i2cspm_instance);
+#endif
 
 /***************************************************************************//**
  * @brief
@@ -167,6 +202,21 @@ sl_status_t vl53l1x_stop_ranging(uint16_t dev);
  ******************************************************************************/
 sl_status_t vl53l1x_set_i2c_address(uint16_t dev, uint8_t new_address);
 
+/***************************************************************************//**
+ * @brief
+ *    This function resets the device. It boots again with the default
+ *    configuration at the default address 0x29, vl53l1x_get_boot_state()
+ *    tells when it is done.
+ *
+ * @param[in] dev
+ *    Device address. (Default: 0x29[0x52])
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_TRANSMIT if I2C transmit failed.
+ ******************************************************************************/
+sl_status_t vl53l1x_software_reset(uint16_t dev);
+
 /***************************************************************************//**
  * @brief
  *    This function clears the interrupt, to be called after a ranging
@@ -518,6 +568,53 @@ sl_status_t vl53l1x_get_range_status(uint16_t dev, uint8_t *range_status);
  ******************************************************************************/
 sl_status_t vl53l1x_get_result(uint16_t dev, vl53l1x_result_t *result);
 
+/***************************************************************************//**
+ * @brief
+ *    This function returns measurements and the range status in a single
+ *    read access and clears the interrupt to arm it for the next data ready
+ *    event.
+ *
+ * @param[in] dev
+ *    Device address. (Default: 0x29[0x52])
+ *
+ * @param[out] result
+ *    Returns the measurement and the range status in a single read access.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_INVALID_PARAMETER if result is invalid.
+ *    SL_STATUS_TRANSMIT if I2C transmit failed.
+ ******************************************************************************/
+sl_status_t vl53l1x_get_result_and_clear_interrupt(uint16_t dev,
+		vl53l1x_result_t *result);
+
+/***************************************************************************//**
+ * @brief
+ *    This function queues the result block read and the interrupt clear on
+ *    the asynchronous I2C transport. The callback is called from interrupt
+ *    context when both transfers are done.
+ *
+ * @param[in] dev
+ *    Device address. (Default: 0x29[0x52])
+ *
+ * @param[in] request
+ *    Request instance, must stay valid until the callback is called.
+ *
+ * @param[in] callback
+ *    Completion callback.
+ *
+ * @param[in] context
+ *    Context pointer passed to the callback.
+ *
+ * @return
+ *    SL_STATUS_OK if the read is queued.
+ *    SL_STATUS_INVALID_PARAMETER if request or callback is invalid.
+ *    SL_STATUS_NO_MORE_RESOURCE if the transfer queue is full.
+ ******************************************************************************/
+sl_status_t vl53l1x_get_result_and_clear_interrupt_async(uint16_t dev,
+		vl53l1x_result_request_t *request,
+		vl53l1x_result_callback_t callback, void *context);
+
 /***************************************************************************//**
  * @brief
  *    This function programs the offset correction in mm.
@@ -633,6 +730,20 @@ sl_status_t vl53l1x_set_distance_threshold(uint16_t dev, uint16_t threshold_low,
 sl_status_t vl53l1x_set_distance_threshold_window_mode(uint16_t dev,
 		uint16_t *window);
 
+/***************************************************************************//**
+ * @brief
+ * This function disables the threshold detection mode, the interrupt is
+ * raised again on every new ranging.
+ *
+ * @param[in] dev
+ *    Device address. (Default: 0x29[0x52])
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_TRANSMIT if I2C transmit failed.
+ ******************************************************************************/
+sl_status_t vl53l1x_clear_distance_threshold(uint16_t dev);
+
 /***************************************************************************//**
  * @brief
  * This function returns the low threshold in mm.
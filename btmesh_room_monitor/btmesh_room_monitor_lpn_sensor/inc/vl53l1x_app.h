@@ -37,12 +37,53 @@
 #ifndef VL53L1X_APP_H
 #define VL53L1X_APP_H
 
+#include <stdbool.h>
+#include <stdint.h>
+#include "sl_status.h"
+#include "people_counting.h"
+
+/**
+ * Sampling rate changes of the doorway activity
+ */
+typedef struct {
+  uint32_t idle_count;          //!< Switches to the idle rate
+  uint32_t idle_time_ms;        //!< Time spent at the idle rate
+  uint32_t wake_latency_ms;     //!< Last delay from someone in a zone to the
+                                //!< first sample at full rate
+  uint32_t wake_latency_max_ms; //!< Longest of these delays
+} vl53l1x_app_activity_stats_t;
+
+/**
+ * Health of the sensors, the worst one
+ */
+typedef enum {
+  VL53L1X_APP_HEALTH_OK = 0,      //!< The rangings are correct
+  VL53L1X_APP_HEALTH_RECOVERING,  //!< A sensor was configured again or reset
+  VL53L1X_APP_HEALTH_FAILED       //!< A sensor could not be recovered
+} vl53l1x_app_health_t;
+
+/**
+ * Recoveries of the sensors
+ */
+typedef struct {
+  uint32_t bus_errors;    //!< Recoveries on failed transfers in a row
+  uint32_t failure_rates; //!< Recoveries on hardware failures of a zone
+  uint32_t stuck;         //!< Recoveries on rangings which do not change
+  uint32_t silences;      //!< Recoveries on missing results
+  uint32_t reconfigures;  //!< Sensors configured again
+  uint32_t resets;        //!< Sensors reset
+} vl53l1x_app_health_stats_t;
+
 /**
  * VL53L1x callback event
  */
 enum VL53L1X_APP_EVENT {
   VL53L1X_APP_EVENT_SOMEONE_ENTER,  //!< Event trigger when someone enter
-  VL53L1X_APP_EVENT_SOMEONE_LEAVE   //!< Event trigger when someone leave
+  VL53L1X_APP_EVENT_SOMEONE_LEAVE,  //!< Event trigger when someone leave
+  VL53L1X_APP_EVENT_CALIBRATED,     //!< Event trigger when the floor is
+                                    //!< calibrated
+  VL53L1X_APP_EVENT_HEALTH_CHANGED  //!< Event trigger when the health of
+                                    //!< the sensors changes
 };
 
 /***************************************************************************//**
@@ -71,6 +112,11 @@ void vl53l1x_app_init(uint16_t min_distance,
  * @brief
  *    Get and process sampling data from the VL53L1x sensor.
  *
+ * @note
+ *    The result is read in the background, the read is started by the data
+ *    ready interrupt or by this function, and the result is processed on the
+ *    next call after vl53l1x_app_on_data_ready() is signaled.
+ *
  ******************************************************************************/
 void vl53l1x_app_process_sampling_data(void);
 
@@ -83,6 +129,18 @@ void vl53l1x_app_process_sampling_data(void);
 *****************************************************************************/
 uint16_t vl53l1x_app_get_current_measured_distance(void);
 
+/**************************************************************************//**
+ * @brief
+ *   Get the number of paths through the zones that were not counted.
+ *
+ * @param[in] type
+ *   Reason of the rejection
+ *
+ * @return
+ *   Rejected paths of all the sensors and lanes since the last calibration
+*****************************************************************************/
+uint32_t vl53l1x_app_get_rejected_path_count(people_counting_reject_t type);
+
 /**************************************************************************//**
  * @brief
  *   Get current number of people count.
@@ -101,6 +159,123 @@ uint16_t vl53l1x_app_get_people_count(void);
 *****************************************************************************/
 void vl53l1x_app_change_timing_budget_in_ms(uint16_t timing_budget);
 
+/**************************************************************************//**
+ * @brief
+ *   Detect the sensors which stopped ranging and recover them. To be called
+ *   periodically while sampling.
+*****************************************************************************/
+void vl53l1x_app_check_health(void);
+
+/**************************************************************************//**
+ * @brief
+ *   Get the health of the sensors.
+ *
+ * @return
+ *   Health of the worst sensor
+*****************************************************************************/
+vl53l1x_app_health_t vl53l1x_app_get_health(void);
+
+/**************************************************************************//**
+ * @brief
+ *   Get the recoveries of the sensors.
+ *
+ * @param[out] stats
+ *   Recoveries by cause and kind
+*****************************************************************************/
+void vl53l1x_app_get_health_stats(vl53l1x_app_health_stats_t *stats);
+
+/**************************************************************************//**
+ * @brief
+ *   Tell whether nobody is in the zones of any lane.
+ *
+ * @return
+ *   false while someone is in a zone or during the floor calibration
+*****************************************************************************/
+bool vl53l1x_app_is_doorway_empty(void);
+
+/**************************************************************************//**
+ * @brief
+ *   Get the sampling rate changes of the doorway activity.
+ *
+ * @param[out] stats
+ *   Switches to the idle rate and delays of the switches back to full rate
+*****************************************************************************/
+void vl53l1x_app_get_activity_stats(vl53l1x_app_activity_stats_t *stats);
+
+/**************************************************************************//**
+ * @brief
+ *   Enable the GPIO1 data ready interrupt of the VL53L1x sensor.
+ *
+ * @note
+ *   The sensor drives GPIO1 low when a ranging data is ready. The line is
+ *   released by the interrupt clear in vl53l1x_app_process_sampling_data().
+*****************************************************************************/
+void vl53l1x_app_start_data_ready_interrupt(void);
+
+/**************************************************************************//**
+ * @brief
+ *   Disable the GPIO1 data ready interrupt of the VL53L1x sensor.
+*****************************************************************************/
+void vl53l1x_app_stop_data_ready_interrupt(void);
+
+/**************************************************************************//**
+ * @brief
+ *   Print the zone thresholds and the trace of the last samples.
+ *
+ * @details
+ *   One line per zone threshold then per sample, oldest first, in the format
+ *   read by tools/people_counting_replay.c. The sampling is held while
+ *   printing.
+*****************************************************************************/
+void vl53l1x_app_dump_trace(void);
+
+/**************************************************************************//**
+ * @brief
+ *   Start the calibration of the zone thresholds.
+ *
+ * @details
+ *   The next rangings measure the floor of each zone of the empty doorway
+ *   instead of counting people. The zone thresholds are derived from the
+ *   floor distances and stored in NVM3, then VL53L1X_APP_EVENT_CALIBRATED is
+ *   signaled.
+*****************************************************************************/
+void vl53l1x_app_start_calibration(void);
+
+/**************************************************************************//**
+ * @brief
+ *   Check whether the zone thresholds are calibrated.
+ *
+ * @return
+ *   true if a calibration is loaded from NVM3 or has been completed
+*****************************************************************************/
+bool vl53l1x_app_is_calibrated(void);
+
+/**************************************************************************//**
+ * @brief
+ *   Calibrate the offset and the crosstalk of the sensors.
+ *
+ * @details
+ *   A grey 17% target has to be placed below the sensors, see UM2555. The
+ *   function blocks until all the sensors are calibrated, the sampling has
+ *   to be stopped. The result is stored in NVM3 with the zone thresholds.
+ *
+ * @param[in] target_distance
+ *   Distance of the target in mm
+ *
+ * @return
+ *   SL_STATUS_OK if the calibration is applied
+*****************************************************************************/
+sl_status_t vl53l1x_app_calibrate_offset_and_xtalk(uint16_t target_distance);
+
+/**************************************************************************//**
+ * @brief
+ *   The callback when a ranging result is read or when its read has to be
+ *   started again, called from interrupt context.
+ *   vl53l1x_app_process_sampling_data() has to be called from the application
+ *   context in both cases.
+*****************************************************************************/
+void vl53l1x_app_on_data_ready(void);
+
 /**************************************************************************//**
  * @brief
  *   The callback when a event triggered: people enter, peole leave.
@@ -39,7 +39,10 @@
 #ifndef VL53L1X_CONFIG_H_
 #define VL53L1X_CONFIG_H_
 
+#ifndef VL53L1X_PLATFORM_EMULATOR
 #include "sl_i2cspm_qwiic_config.h"
+#include "em_gpio.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -47,6 +50,62 @@ extern "C" {
 
 #define VL53L1X_ADDR (0x29) // Device I2C address
 #define VL53L1X_CONFIG_I2C_INSTANCE SL_I2CSPM_QWIIC_PERIPHERAL // I2CSPM instance
+#define VL53L1X_CONFIG_I2C_IRQ          I2C0_IRQn       // IRQ of the I2C instance
+#define VL53L1X_CONFIG_I2C_IRQ_HANDLER  I2C0_IRQHandler // Handler of the I2C IRQ
+#define VL53L1X_CONFIG_I2C_QUEUE_SIZE   4               // Async transfer queue depth
+#define VL53L1X_CONFIG_SHADOW_SIZE      4               // Devices with a register shadow
+
+// Data ready signaling: 1 = GPIO1 interrupt, 0 = polling over I2C
+#ifdef VL53L1X_PLATFORM_EMULATOR
+// Host builds poll the emulated registers
+#define VL53L1X_CONFIG_INT_ENABLE   0
+#else
+#define VL53L1X_CONFIG_INT_ENABLE   1
+#endif
+#define VL53L1X_CONFIG_INT_PORT     gpioPortD // GPIO1 (INT) pin port
+#define VL53L1X_CONFIG_INT_PIN      10        // GPIO1 (INT) pin number
+
+// Sensors on the bus, each one watching its own pair of zones. With more
+// than one sensor they are released from reset one by one through XSHUT and
+// moved to their own address, and they range in turn to avoid cross-talk.
+// The GPIO1 outputs are wired together on the INT pin.
+#define VL53L1X_CONFIG_SENSOR_COUNT     1
+#define VL53L1X_CONFIG_SENSOR_ADDRS     { VL53L1X_ADDR } // 7-bit addresses
+#define VL53L1X_CONFIG_XSHUT_PORTS      { gpioPortD }    // XSHUT pin ports
+#define VL53L1X_CONFIG_XSHUT_PINS       { 11 }           // XSHUT pin numbers
+// Same direction events of two sensors closer than this are counted once,
+// 0 when the sensors watch separate entrances
+#define VL53L1X_CONFIG_MERGE_WINDOW_MS  0
+
+// Lanes watched by each sensor, each lane has a front and a back zone and
+// counts the people walking through it on its own. The zones are scanned in
+// turn: front and back of lane 0, then of lane 1, ... An entry is walking
+// from the front to the back zone of a lane.
+// Zone: { ROI center SPAD, ROI width, ROI height }, see the SPAD map in UM2555
+#define VL53L1X_CONFIG_LANE_COUNT       1
+#define VL53L1X_CONFIG_ZONES            { { 231, 8, 16 }, { 175, 8, 16 } }
+
+// NVM3 object of the calibration of the installation
+#define VL53L1X_CONFIG_NVM3_CALIBRATION_KEY  0x0100
+
+// Sampling rate of an empty doorway: when nobody has been in the zones for
+// VL53L1X_CONFIG_IDLE_DELAY_MS the rangings are spaced by
+// VL53L1X_CONFIG_IDLE_PERIOD_MS, and back to back again as soon as someone
+// is in a zone. 0 keeps the full rate.
+#define VL53L1X_CONFIG_IDLE_DELAY_MS    5000
+#define VL53L1X_CONFIG_IDLE_PERIOD_MS   100
+// Timing budget of the idle rangings, shorter than the one at full rate so
+// that the sensor spends less time ranging in each idle period. 20 is the
+// shortest budget in long distance mode.
+#define VL53L1X_CONFIG_IDLE_TIMING_BUDGET_MS  20
+// With one sensor, the idle rangings cover all the zones with one ROI and
+// only signal a distance below the lowest zone threshold, so that the MCU
+// sleeps until someone comes. 0 samples the zones at the idle period.
+#define VL53L1X_CONFIG_IDLE_THRESHOLD_WAKE  1
+
+// RAM kept for the trace of the last samples in bytes, about 6 bytes per
+// sample, 0 to disable
+#define VL53L1X_CONFIG_TRACE_SIZE       2048
 
 #ifdef __cplusplus
 }
@@ -82,6 +82,7 @@ typedef sl_status_t VL53L1X_ERROR;
 #define SYSTEM__INTERRUPT_CLEAR       						0x0086
 #define SYSTEM__MODE_START                 					0x0087
 #define VL53L1_RESULT__RANGE_STATUS							0x0089
+#define VL53L1_RESULT__BLOCK_SIZE							17
 #define VL53L1_RESULT__DSS_ACTUAL_EFFECTIVE_SPADS_SD0		0x008C
 #define RESULT__AMBIENT_COUNT_RATE_MCPS_SD					0x0090
 #define VL53L1_RESULT__FINAL_CROSSTALK_CORRECTED_RANGE_MM_SD0				0x0096
@@ -261,6 +262,18 @@ VL53L1X_ERROR VL53L1X_GetRangeStatus(uint16_t dev, uint8_t *rangeStatus);
  */
 VL53L1X_ERROR VL53L1X_GetResult(uint16_t dev, VL53L1X_Result_t *pResult);
 
+/**
+ * @brief This function decodes a result block read from VL53L1_RESULT__RANGE_STATUS
+ * @param pRaw: VL53L1_RESULT__BLOCK_SIZE bytes of the result block
+ */
+void VL53L1X_DecodeResult(const uint8_t *pRaw, VL53L1X_Result_t *pResult);
+
+/**
+ * @brief This function returns measurements and the range status in a single read access
+ * and clears the interrupt to arm it for the next data ready event
+ */
+VL53L1X_ERROR VL53L1X_GetResultAndClearInterrupt(uint16_t dev, VL53L1X_Result_t *pResult);
+
 /**
  * @brief This function programs the offset correction in mm
  * @param OffsetValue:the offset correction value to program in mm
@@ -39,6 +39,7 @@
 #include "sl_btmesh_api.h"
 #include "sl_btmesh_factory_reset.h"
 #include "sl_btmesh_sensor_people_count.h"
+#include "sl_btmesh_device_properties.h"
 #include "sl_btmesh_dcd.h"
 #include "sl_bt_api.h"
 
@@ -83,6 +84,10 @@
 #define PB_ADV                         0x1
 /// GATT Provisioning Bearer
 #define PB_GATT                        0x2
+/// Sensor Setting Set sent with acknowledgement
+#define SETTING_RESPONSE_REQUIRED      0x02
+/// Element of the sensor setup server
+#define SENSOR_ELEMENT                 0
 
 /// periodic timer handle
 static sl_sleeptimer_timer_handle_t app_led_blinking_timer;
@@ -92,6 +97,8 @@ static void stop_led_blink(void);
 static void app_led_blinking_timer_cb(sl_sleeptimer_timer_handle_t *timer, void *data);
 static void handle_boot_event(void);
 static void handle_node_initialized_event(sl_btmesh_evt_node_initialized_t *evt);
+static void handle_set_setting_request(
+  sl_btmesh_evt_sensor_setup_server_set_setting_request_t *evt);
 static bool handle_reset_conditions(void);
 
 /**************************************************************************//**
@@ -130,6 +137,8 @@ void sl_bt_on_event(struct sl_bt_msg *evt)
     case sl_bt_evt_system_external_signal_id:
       people_counting_process_evt_external_signal(
           evt->data.evt_system_external_signal.extsignals);
+      app_display_process_evt_external_signal(
+          evt->data.evt_system_external_signal.extsignals);
       break;
 
     // -------------------------------
@@ -171,6 +180,11 @@ void sl_btmesh_on_event(sl_btmesh_msg_t *evt)
       led0_off();
       break;
 
+    case sl_btmesh_evt_sensor_setup_server_set_setting_request_id:
+      handle_set_setting_request(
+        &(evt->data.evt_sensor_setup_server_set_setting_request));
+      break;
+
     // -------------------------------
     // Default event handler.
     default:
@@ -297,6 +311,43 @@ static void handle_node_initialized_event(sl_btmesh_evt_node_initialized_t *evt)
   }
 }
 
+/***************************************************************************//**
+ * Handling of sensor setting set request.
+ * The people count setting resets or sets the count from a sensor client.
+ *
+ * @param[in] evt  Pointer to sensor setup server set setting request event.
+ ******************************************************************************/
+static void handle_set_setting_request(
+  sl_btmesh_evt_sensor_setup_server_set_setting_request_t *evt)
+{
+  uint16_t count;
+  sl_status_t sc;
+
+  if ((PEOPLE_COUNT != evt->property_id)
+      || (ROOM_MONITOR_PEOPLE_COUNT_SETTING_ID != evt->setting_id)
+      || (2 != evt->raw_value.len)) {
+    return;
+  }
+  count = (uint16_t)(evt->raw_value.data[0]
+                     | (evt->raw_value.data[1] << 8));
+  room_monitor_app_set_people_count(count);
+  if (evt->flags & SETTING_RESPONSE_REQUIRED) {
+    sc = sl_btmesh_sensor_setup_server_send_setting_status(
+      evt->client_address,
+      SENSOR_ELEMENT,
+      evt->appkey_index,
+      0,
+      evt->property_id,
+      evt->setting_id,
+      evt->raw_value.len,
+      evt->raw_value.data);
+    if (SL_STATUS_OK != sc) {
+      log_error("Failed to send setting status: 0x%lx\r\n",
+                (unsigned long)sc);
+    }
+  }
+}
+
 /***************************************************************************//**
  * Handles button press and does a factory reset
  *
@@ -36,6 +36,7 @@
 #include "stdio.h"
 #include "string.h"
 #include "sl_status.h"
+#include "sl_bt_api.h"
 
 #include "app_log.h"
 #include "app_assert.h"
@@ -45,6 +46,10 @@
 
 #define LINE_MAX_CHAR (8)
 
+// External signal to send the display update in the background, it must
+// differ from the signals of room_monitor_app.c
+#define APP_DISPLAY_REFRESH_EVENT (1<<6)
+
 enum DISPLAY_PAGE {
   DISPLAY_PAGE_NONE,
   DISPLAY_PAGE_UNPROVISIONED,
@@ -66,6 +71,8 @@ static void app_simple_timer_display_cb(sl_simple_timer_t *handle, void *data);
 
 static void init_display_page(enum DISPLAY_PAGE display_page);
 
+static void display_refresh(void);
+
 /* This array is generated by LCDAssistant Tool. A image with bitmap format can
  * use this tool to convert to code.
  * To draw an image or custom bitmaps on the oled, the glib_draw_bmp()
@@ -156,7 +163,7 @@ void app_display_show_unprovisioned(void)
   display.first_letter = display.param_text;
   display.text_length = strlen((char*) display.param_text);
 
-  glib_update_display();
+  display_refresh();
 
   // Setup a timer for display animations
   sl_status_t sc = sl_simple_timer_start(&display.timer_handle,
@@ -178,6 +185,7 @@ void app_display_show_factory_reset(void)
   glib_clear(&glib_context);
   glib_draw_string(&glib_context, "FACTORY", 4, 15);
   glib_draw_string(&glib_context, "RESET", 12, 30);
+  // The device resets right after, the screen must be sent now
   glib_update_display();
 }
 
@@ -211,7 +219,7 @@ void app_display_show_people_count(uint32_t people_count)
     glib_draw_string(&glib_context, number_str, 0, 19);
   }
 
-  glib_update_display();
+  display_refresh();
 }
 
 /***************************************************************************//**
@@ -231,10 +239,32 @@ void app_display_show_friend_status(bool status) {
     glib_set_font(&glib_context, (glib_font_t *) &glib_font_6x8);
     glib_draw_string(&glib_context, tmp, 0, 37);
 
-    glib_update_display();
+    display_refresh();
   }
 }
 
+/***************************************************************************//**
+ * Handle the external signal of the background display update.
+ ******************************************************************************/
+void app_display_process_evt_external_signal(uint32_t extsignals)
+{
+  if (extsignals & APP_DISPLAY_REFRESH_EVENT) {
+    // One page per event, so the other events are not held up
+    if (glib_process_update()) {
+      sl_bt_external_signal(APP_DISPLAY_REFRESH_EVENT);
+    }
+  }
+}
+
+/***************************************************************************//**
+ * Request a display update, it is sent in the background.
+ ******************************************************************************/
+static void display_refresh(void)
+{
+  glib_request_update();
+  sl_bt_external_signal(APP_DISPLAY_REFRESH_EVENT);
+}
+
 static void init_display_page(enum DISPLAY_PAGE display_page)
 {
   if(current_display_page != display_page) {
@@ -306,5 +336,5 @@ static void app_simple_timer_display_cb(sl_simple_timer_t *handle,
   display_set_paramline_next_text(param_text_buffer);
   glib_draw_string(&glib_context, (char*) param_text_buffer, 1, 4);
   // Update display
-  glib_update_display();
+  display_refresh();
 }
@@ -59,6 +59,33 @@ static const ssd1306_t *oled = NULL;
 /* Dimensions of the display */
 static glib_display_geometry_t dimensions;
 
+/* Number of pages of the display, 8 rows each */
+#define GLIB_PAGES              (SSD1306_DISPLAY_HEIGHT / 8)
+
+/* Columns of each page changed since the last update of the display. A page
+ * is unchanged while its first dirty column is after its last one. */
+static uint8_t glib_dirty_first[GLIB_PAGES];
+static uint8_t glib_dirty_last[GLIB_PAGES];
+
+/* Copy of the frame sent by glib_process_update(), with the columns of each
+ * page left to send. Drawing goes on in glib_frame_buffer meanwhile. */
+static uint8_t glib_send_buffer[sizeof(glib_frame_buffer)];
+static uint8_t glib_send_first[GLIB_PAGES];
+static uint8_t glib_send_last[GLIB_PAGES];
+static uint8_t glib_send_page = GLIB_PAGES;
+
+/* An update was requested, the transfer starts after the current one */
+static bool glib_update_requested = false;
+
+static void glib_mark_dirty(uint8_t page, uint8_t first, uint8_t last);
+static void glib_mark_all_dirty(void);
+static void glib_mark_clean(uint8_t page);
+static void glib_start_send(void);
+static bool glib_send_next_page(void);
+static void glib_write_byte(uint32_t index, uint8_t value);
+static void glib_blit_char(glib_context_t *pContext, char my_char,
+                           int32_t x, int32_t y);
+
 /**************************************************************************//**
  * @brief
  *   Initialization function for the glib.
@@ -90,6 +117,9 @@ glib_status_t glib_init(void)
   dimensions.xSize = oled->width;
   dimensions.ySize = oled->height;
 
+  /* The content of the display RAM is unknown */
+  glib_mark_all_dirty();
+
   return GLIB_OK;
 }
 
@@ -115,7 +145,7 @@ glib_status_t glib_clear(glib_context_t *pContext)
 
   /* Fill the display with the background color of the glib_context_t  */
   for (i = 0; i < sizeof(glib_frame_buffer); i++) {
-      glib_frame_buffer[i] = (pContext->backgroundColor == Black) ? 0x00 : 0xFF;
+      glib_write_byte(i, (pContext->backgroundColor == Black) ? 0x00 : 0xFF);
   }
 
   return GLIB_OK;
@@ -138,21 +168,24 @@ glib_status_t glib_clear(glib_context_t *pContext)
 ******************************************************************************/
 glib_status_t glib_draw_pixel(glib_context_t *pContext, int32_t x, int32_t y)
 {
+  uint32_t index;
+
   /* Check arguments */
   if (pContext == NULL) {
     return GLIB_ERROR_INVALID_ARGUMENT;
   }
 
-  if ((x > dimensions.xSize)
-   || (y > dimensions.ySize)) {
+  if ((x < 0) || (x >= dimensions.xSize)
+   || (y < 0) || (y >= dimensions.ySize)) {
       return GLIB_ERROR_INVALID_REGION;
   }
 
+  index = x + (y / 8) * dimensions.xSize;
   if (pContext->foregroundColor == White) {
-    glib_frame_buffer[x + (y / 8) * dimensions.xSize] |= 1 << (y % 8);
+    glib_write_byte(index, glib_frame_buffer[index] | (1 << (y % 8)));
   }
   else {
-    glib_frame_buffer[x + (y / 8) * dimensions.xSize] &= ~(1 << (y % 8));
+    glib_write_byte(index, glib_frame_buffer[index] & ~(1 << (y % 8)));
   }
 
   return GLIB_OK;
@@ -174,22 +207,24 @@ glib_status_t glib_draw_pixel(glib_context_t *pContext, int32_t x, int32_t y)
 ******************************************************************************/
 glib_status_t glib_earse_pixel(glib_context_t *pContext, int32_t x, int32_t y)
 {
+  uint32_t index;
 
   /* Check arguments */
   if (pContext == NULL) {
     return GLIB_ERROR_INVALID_ARGUMENT;
   }
 
-  if ((x > dimensions.xSize)
-   || (y > dimensions.ySize)) {
+  if ((x < 0) || (x >= dimensions.xSize)
+   || (y < 0) || (y >= dimensions.ySize)) {
       return GLIB_ERROR_INVALID_REGION;
   }
 
+  index = x + (y / 8) * dimensions.xSize;
   if (pContext->foregroundColor == White) {
-    glib_frame_buffer[x + (y / 8) * dimensions.xSize] &= ~(1 << (y % 8));
+    glib_write_byte(index, glib_frame_buffer[index] & ~(1 << (y % 8)));
   }
   else {
-    glib_frame_buffer[x + (y / 8) * dimensions.xSize] |= 1 << (y % 8);
+    glib_write_byte(index, glib_frame_buffer[index] | (1 << (y % 8)));
   }
 
   return GLIB_OK;
@@ -229,6 +264,12 @@ glib_status_t glib_draw_char(glib_context_t *pContext, char my_char, int32_t x,
     return GLIB_ERROR_INVALID_CHAR;
   }
 
+  /* Copy whole bytes of the glyph when the font has them */
+  if (pContext->font.columns != NULL) {
+    glib_blit_char(pContext, my_char, x, y);
+    return GLIB_OK;
+  }
+
   // Use the font to write
   for (i = 0; i < pContext->font.height; i++) {
     pixelData = pContext->font.data[(my_char - 32) * pContext->font.height + i];
@@ -482,7 +523,78 @@ glib_status_t glib_draw_circle(glib_context_t *pContext, uint8_t par_x, uint8_t
 ******************************************************************************/
 glib_status_t glib_update_display(void)
 {
-  return ((ssd1306_draw(glib_frame_buffer) == SL_STATUS_OK) ? GLIB_OK : GLIB_ERROR_OUT_OF_MEMORY);
+  glib_status_t status = GLIB_OK;
+  uint8_t page = 0;
+  uint8_t first_page;
+  uint8_t first;
+  uint8_t last;
+
+  /* Finish the background transfer first, this update covers the request */
+  while (glib_send_next_page()) {
+  }
+  glib_update_requested = false;
+
+  while (page < GLIB_PAGES) {
+    if (glib_dirty_first[page] > glib_dirty_last[page]) {
+      page++;
+      continue;
+    }
+
+    /* Send the changed pages in a row through one window */
+    first_page = page;
+    first = glib_dirty_first[page];
+    last = glib_dirty_last[page];
+    while ((page < GLIB_PAGES)
+           && (glib_dirty_first[page] <= glib_dirty_last[page])) {
+      if (glib_dirty_first[page] < first) {
+        first = glib_dirty_first[page];
+      }
+      if (glib_dirty_last[page] > last) {
+        last = glib_dirty_last[page];
+      }
+      page++;
+    }
+
+    if (ssd1306_draw_region(glib_frame_buffer,
+                            first_page, page - 1,
+                            first, last) == SL_STATUS_OK) {
+      while (first_page < page) {
+        glib_mark_clean(first_page++);
+      }
+    }
+    else {
+      /* Keep the pages dirty, the next update sends them again */
+      status = GLIB_ERROR_OUT_OF_MEMORY;
+    }
+  }
+
+  return status;
+}
+
+/**************************************************************************//**
+*  @brief
+*  Request an update of the display in the background.
+******************************************************************************/
+void glib_request_update(void)
+{
+  glib_update_requested = true;
+}
+
+/**************************************************************************//**
+*  @brief
+*  Send one page of the requested update to the display device.
+*
+*  @return
+*  Returns true while pages are left to send.
+******************************************************************************/
+bool glib_process_update(void)
+{
+  if ((glib_send_page >= GLIB_PAGES) && glib_update_requested) {
+    glib_update_requested = false;
+    glib_start_send();
+  }
+
+  return glib_send_next_page() || glib_update_requested;
 }
 
 /**************************************************************************//**
@@ -505,6 +617,11 @@ glib_status_t glib_draw_bmp(glib_context_t *pContext, const uint8_t *data)
 {
   (void) pContext;
 
+  /* The bitmap is not in the glib_frame_buffer, the next update redraws the
+   * whole display */
+  glib_mark_all_dirty();
+  glib_send_page = GLIB_PAGES;
+
   return ((ssd1306_draw(data) == SL_STATUS_OK) ? GLIB_OK : GLIB_ERROR_OUT_OF_MEMORY);
 }
 
@@ -629,6 +746,9 @@ glib_status_t glib_scroll_diag_left(uint8_t start_page_addr, uint8_t end_page_ad
  *****************************************************************************/
 glib_status_t glib_stop_scroll(void)
 {
+  /* The display RAM has to be written again after a scroll */
+  glib_mark_all_dirty();
+
   return ((ssd1306_stop_scroll() == SL_STATUS_OK) ? GLIB_OK : GLIB_ERROR_IO);
 }
 
@@ -646,3 +766,173 @@ glib_status_t glib_enable_display(bool on)
 {
   return ((ssd1306_enable_display(on) == SL_STATUS_OK) ? GLIB_OK : GLIB_ERROR_IO);
 }
+
+/**************************************************************************//**
+ * @brief
+ *   Add columns of a page to the region sent by the next update.
+ *****************************************************************************/
+static void glib_mark_dirty(uint8_t page, uint8_t first, uint8_t last)
+{
+  if (first < glib_dirty_first[page]) {
+    glib_dirty_first[page] = first;
+  }
+  if (last > glib_dirty_last[page]) {
+    glib_dirty_last[page] = last;
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Send the whole glib_frame_buffer at the next update.
+ *****************************************************************************/
+static void glib_mark_all_dirty(void)
+{
+  uint8_t page;
+
+  for (page = 0; page < GLIB_PAGES; page++) {
+    glib_mark_dirty(page, 0, SSD1306_DISPLAY_WIDTH - 1);
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Mark a page as sent to the display.
+ *****************************************************************************/
+static void glib_mark_clean(uint8_t page)
+{
+  glib_dirty_first[page] = UINT8_MAX;
+  glib_dirty_last[page] = 0;
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Copy the changed columns of the glib_frame_buffer for a background
+ *   transfer, they are clean again for the drawing.
+ *****************************************************************************/
+static void glib_start_send(void)
+{
+  uint8_t page;
+  uint32_t offset;
+
+  glib_send_page = GLIB_PAGES;
+  for (page = 0; page < GLIB_PAGES; page++) {
+    glib_send_first[page] = glib_dirty_first[page];
+    glib_send_last[page] = glib_dirty_last[page];
+    if (glib_dirty_first[page] > glib_dirty_last[page]) {
+      continue;
+    }
+    offset = page * SSD1306_DISPLAY_WIDTH + glib_dirty_first[page];
+    memcpy(&glib_send_buffer[offset], &glib_frame_buffer[offset],
+           glib_dirty_last[page] - glib_dirty_first[page] + 1);
+    glib_mark_clean(page);
+    if (glib_send_page == GLIB_PAGES) {
+      glib_send_page = page;
+    }
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Send the next page of the background transfer.
+ *
+ * @return
+ *   true while pages are left to send.
+ *****************************************************************************/
+static bool glib_send_next_page(void)
+{
+  uint8_t page = glib_send_page;
+
+  if (page >= GLIB_PAGES) {
+    return false;
+  }
+
+  if (ssd1306_draw_region(glib_send_buffer, page, page,
+                          glib_send_first[page],
+                          glib_send_last[page]) != SL_STATUS_OK) {
+    /* Not shown, the page is sent again with the next update */
+    glib_mark_dirty(page, glib_send_first[page], glib_send_last[page]);
+    glib_update_requested = true;
+  }
+
+  /* Find the next page to send */
+  do {
+    page++;
+  } while ((page < GLIB_PAGES)
+           && (glib_send_first[page] > glib_send_last[page]));
+  glib_send_page = page;
+
+  return page < GLIB_PAGES;
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Write a byte of the glib_frame_buffer, its column is sent by the next
+ *   update only if the byte changed.
+ *****************************************************************************/
+static void glib_write_byte(uint32_t index, uint8_t value)
+{
+  uint8_t column = index % SSD1306_DISPLAY_WIDTH;
+
+  if (glib_frame_buffer[index] != value) {
+    glib_frame_buffer[index] = value;
+    glib_mark_dirty(index / SSD1306_DISPLAY_WIDTH, column, column);
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Draw a char from the font columns, 8 rows at a time. Each band of the
+ *   glyph covers up to two pages of the glib_frame_buffer, the rows of the
+ *   char cell are replaced and the others kept.
+ *****************************************************************************/
+static void glib_blit_char(glib_context_t *pContext, char my_char,
+                           int32_t x, int32_t y)
+{
+  uint8_t bands = (pContext->font.height + 7) / 8;
+  const uint8_t *glyph = pContext->font.columns
+                         + (my_char - 32) * pContext->font.width * bands;
+  uint8_t invert = (pContext->foregroundColor == White) ? 0x00 : 0xFF;
+  /* Page of the top row, rounded down for a char above the display */
+  int32_t top = (y >= 0) ? (y / 8) : ((y - 7) / 8);
+  uint8_t shift = y - top * 8;
+  uint8_t rows;
+  uint16_t bits;
+  uint16_t mask;
+  uint8_t page_mask;
+  uint32_t index;
+  int32_t page;
+  int32_t column;
+  uint8_t band;
+  uint8_t i;
+  uint8_t j;
+
+  for (band = 0; band < bands; band++) {
+    /* Rows of the cell in this band, the last band may be partial */
+    rows = pContext->font.height - band * 8;
+    if (rows > 8) {
+      rows = 8;
+    }
+    mask = ((1 << rows) - 1) << shift;
+
+    for (i = 0; i < pContext->font.width; i++) {
+      column = x + i;
+      if ((column < 0) || (column >= dimensions.xSize)) {
+        continue;
+      }
+      bits = ((glyph[band * pContext->font.width + i] ^ invert)
+              & ((1 << rows) - 1)) << shift;
+
+      /* Lower part in the first page, the rest in the next one */
+      for (j = 0; j < 2; j++) {
+        page = top + band + j;
+        page_mask = mask >> (j * 8);
+        if ((page < 0) || (page >= GLIB_PAGES) || (page_mask == 0)) {
+          continue;
+        }
+        index = column + page * dimensions.xSize;
+        glib_write_byte(index, (glib_frame_buffer[index] & ~page_mask)
+                               | (uint8_t) (bits >> (j * 8)));
+      }
+    }
+  }
+}
@@ -0,0 +1,209 @@
+/***************************************************************************//**
+ * @file i2c_bus_arbiter.c
+ * @brief Shared I2C bus arbiter
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+#include <string.h>
+#include "em_core.h"
+#include "em_emu.h"
+#include "sl_sleeptimer.h"
+#include "i2c_bus_arbiter.h"
+
+/***************************************************************************//**
+ * @addtogroup i2c_bus_arbiter
+ * @{
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+// Defines
+
+#define I2C_BUS_OWNER_NONE        I2C_BUS_CLIENT_COUNT
+
+// -----------------------------------------------------------------------------
+// Private variables
+
+static volatile uint8_t bus_owner = I2C_BUS_OWNER_NONE;
+static volatile uint8_t pending_mask;
+static i2c_bus_arbiter_grant_callback_t grant_callback[I2C_BUS_CLIENT_COUNT];
+static uint32_t request_tick[I2C_BUS_CLIENT_COUNT];
+static uint32_t grant_tick[I2C_BUS_CLIENT_COUNT];
+static i2c_bus_arbiter_stats_t client_stats[I2C_BUS_CLIENT_COUNT];
+
+// -----------------------------------------------------------------------------
+// Private function declarations
+
+static bool request_locked(i2c_bus_client_t client,
+                           i2c_bus_arbiter_grant_callback_t on_grant);
+static void grant_locked(i2c_bus_client_t client);
+
+// -----------------------------------------------------------------------------
+// Public function definitions
+
+/**************************************************************************//**
+ * Request the bus without blocking.
+ *****************************************************************************/
+bool i2c_bus_arbiter_request(i2c_bus_client_t client,
+                             i2c_bus_arbiter_grant_callback_t on_grant)
+{
+  bool granted;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  granted = request_locked(client, on_grant);
+  CORE_EXIT_ATOMIC();
+
+  return granted;
+}
+
+/**************************************************************************//**
+ * Request the bus and wait until it is granted.
+ *****************************************************************************/
+void i2c_bus_arbiter_acquire(i2c_bus_client_t client)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  // PRIMASK only, the transfer interrupt of the owner must wake up the core
+  CORE_ENTER_CRITICAL();
+  if (!request_locked(client, NULL)) {
+    while (bus_owner != client) {
+      // The owner releases the bus from its transfer interrupt
+      EMU_EnterEM1();
+      CORE_EXIT_CRITICAL();
+      CORE_ENTER_CRITICAL();
+    }
+  }
+  CORE_EXIT_CRITICAL();
+}
+
+/**************************************************************************//**
+ * Release the bus.
+ *****************************************************************************/
+void i2c_bus_arbiter_release(i2c_bus_client_t client)
+{
+  i2c_bus_arbiter_grant_callback_t callback = NULL;
+  uint32_t hold;
+  uint8_t next;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  if (bus_owner != client) {
+    CORE_EXIT_ATOMIC();
+    return;
+  }
+  hold = sl_sleeptimer_get_tick_count() - grant_tick[client];
+  if (hold > client_stats[client].hold_max) {
+    client_stats[client].hold_max = hold;
+  }
+  bus_owner = I2C_BUS_OWNER_NONE;
+
+  // Clients are numbered in decreasing order of priority
+  for (next = 0; next < I2C_BUS_CLIENT_COUNT; next++) {
+    if (pending_mask & (1 << next)) {
+      grant_locked((i2c_bus_client_t)next);
+      callback = grant_callback[next];
+      break;
+    }
+  }
+  // The new owner starts its transfer before anybody else can request
+  if (NULL != callback) {
+    callback();
+  }
+  CORE_EXIT_ATOMIC();
+}
+
+/**************************************************************************//**
+ * Get the latency statistics of a client.
+ *****************************************************************************/
+void i2c_bus_arbiter_get_stats(i2c_bus_client_t client,
+                               i2c_bus_arbiter_stats_t *stats)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  *stats = client_stats[client];
+  CORE_EXIT_ATOMIC();
+}
+
+/**************************************************************************//**
+ * Clear the latency statistics.
+ *****************************************************************************/
+void i2c_bus_arbiter_reset_stats(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  memset(client_stats, 0, sizeof(client_stats));
+  CORE_EXIT_ATOMIC();
+}
+
+// -----------------------------------------------------------------------------
+// Private function
+
+static bool request_locked(i2c_bus_client_t client,
+                           i2c_bus_arbiter_grant_callback_t on_grant)
+{
+  uint8_t higher_mask = (1 << client) - 1;
+
+  if (bus_owner == client) {
+    return true;
+  }
+  request_tick[client] = sl_sleeptimer_get_tick_count();
+  // Do not overtake a pending client of higher priority
+  if ((I2C_BUS_OWNER_NONE == bus_owner) && !(pending_mask & higher_mask)) {
+    grant_locked(client);
+    return true;
+  }
+  pending_mask |= (1 << client);
+  grant_callback[client] = on_grant;
+  client_stats[client].contentions++;
+
+  return false;
+}
+
+static void grant_locked(i2c_bus_client_t client)
+{
+  uint32_t now = sl_sleeptimer_get_tick_count();
+  uint32_t wait = now - request_tick[client];
+
+  pending_mask &= ~(1 << client);
+  bus_owner = client;
+  grant_tick[client] = now;
+
+  client_stats[client].grants++;
+  client_stats[client].wait_total += wait;
+  if (wait > client_stats[client].wait_max) {
+    client_stats[client].wait_max = wait;
+  }
+}
+
+/** @} (end group i2c_bus_arbiter) */
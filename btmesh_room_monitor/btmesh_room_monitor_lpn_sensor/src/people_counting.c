@@ -0,0 +1,429 @@
+/***************************************************************************//**
+ * @file people_counting.c
+ * @brief People counting algorithm on two zone distance samples
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "people_counting.h"
+
+// -----------------------------------------------------------------------------
+// Logging
+#define TAG "people counting"
+// use applog for the log printing
+#if defined(SL_CATALOG_APP_LOG_PRESENT) && APP_LOG_ENABLE
+#include "app_log.h"
+#define log_info(fmt, ...)  app_log_info("[" TAG "] " fmt, ##__VA_ARGS__)
+#define log_error(fmt, ...) app_log_error("[" TAG "] " fmt, ##__VA_ARGS__)
+// use stdio printf for the log printing
+#elif defined(SL_CATALOG_RETARGET_STDIO_PRESENT)
+#define log_info(fmt, ...)   printf("[" TAG "] " fmt, ##__VA_ARGS__)
+#define log_error(fmt, ...)  printf("[" TAG "] " fmt, ##__VA_ARGS__)
+#else  // the logging is disabled
+#define log_info(...)
+#define log_error(...)
+#endif // #if defined(SL_CATALOG_APP_LOG_PRESENT)
+
+/***************************************************************************//**
+ * @addtogroup people_counting
+ * @brief  People counting algorithm.
+ * @details
+ *   Each sample gets a presence score from its distance, its signal and
+ *   ambient rates compared to the empty zone. Each zone is either empty or
+ *   occupied depending on the maximum, or the median, of its last scores.
+ *   Each change of the occupied zones moves
+ *   the path state through a transition table: an entry is left only, both,
+ *   right only, then nobody, and an exit is the reverse.
+ * @{
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+// Defines
+
+#define NOBODY                    0
+#define SOMEONE                   1
+#define LEFT                      0
+#define RIGHT                     1
+
+// Presence score of a sample, integer only
+#define SCORE_MAX                 255
+#define SCORE_PRESENT             128  // occupied from this score on
+#define SCORE_DISTANCE_WEIGHT     8    // weight of a valid distance
+#define SCORE_SIGNAL_WEIGHT       1    // weight of the signal rate
+#define DISTANCE_MARGIN_SHIFT     3    // score ramp of threshold +/- 1/8
+#define SIGNAL_RATIO_MAX          4    // signal score is max at 4x the floor
+#define AMBIENT_RATIO_SUNLIT      2    // invalid samples in sunlight are held
+#define BASELINE_SHIFT            5    // baselines follow 1/32 of a change
+#define HOLD_MAX                  8    // samples held at most in a row
+
+// Zones occupied, index of the transition table columns
+#define OCCUPIED_NONE             0
+#define OCCUPIED_LEFT             1
+#define OCCUPIED_RIGHT            2
+#define OCCUPIED_BOTH             3
+
+// Path states, named after the zones occupied since the doorway was empty:
+// L = left, B = both, R = right. A person tailgating the first one makes the
+// B after R, then the first one leaving is the P (pending) state.
+#define PATH_STATES(X) \
+  X(IDLE)              \
+  X(L)                 \
+  X(LB)                \
+  X(LBR)               \
+  X(LBRB)              \
+  X(LP)                \
+  X(R)                 \
+  X(RB)                \
+  X(RBL)               \
+  X(RBLB)              \
+  X(RP)                \
+  X(UNKNOWN)
+
+// Path grammar: next state and action from each state when the zones
+// occupied become none, left, right or both.
+#define PATH_TRANSITIONS(X)                                             \
+  X(IDLE,    T(IDLE, NONE),        T(L, NONE),     T(R, NONE),          \
+             T(UNKNOWN, NONE))                                          \
+  X(L,       T(IDLE, TURNED_BACK), T(L, NONE),     T(LBR, NONE),        \
+             T(LB, NONE))                                               \
+  X(LB,      T(IDLE, AMBIGUOUS),   T(L, NONE),     T(LBR, NONE),        \
+             T(LB, NONE))                                               \
+  X(LBR,     T(IDLE, ENTER),       T(L, ENTER),    T(LBR, NONE),        \
+             T(LBRB, NONE))                                             \
+  X(LBRB,    T(IDLE, ENTER),       T(LP, NONE),    T(LBR, NONE),        \
+             T(LBRB, NONE))                                             \
+  X(LP,      T(IDLE, AMBIGUOUS),   T(LP, NONE),    T(LBR, ENTER),       \
+             T(LB, ENTER))                                              \
+  X(R,       T(IDLE, TURNED_BACK), T(RBL, NONE),   T(R, NONE),          \
+             T(RB, NONE))                                               \
+  X(RB,      T(IDLE, AMBIGUOUS),   T(RBL, NONE),   T(R, NONE),          \
+             T(RB, NONE))                                               \
+  X(RBL,     T(IDLE, LEAVE),       T(RBL, NONE),   T(R, LEAVE),         \
+             T(RBLB, NONE))                                             \
+  X(RBLB,    T(IDLE, LEAVE),       T(RBL, NONE),   T(RP, NONE),         \
+             T(RBLB, NONE))                                             \
+  X(RP,      T(IDLE, AMBIGUOUS),   T(RBL, LEAVE),  T(RP, NONE),         \
+             T(RB, LEAVE))                                              \
+  X(UNKNOWN, T(IDLE, AMBIGUOUS),   T(UNKNOWN, NONE), T(UNKNOWN, NONE),  \
+             T(UNKNOWN, NONE))
+
+// Actions of the transitions
+#define ACTION_NONE               0
+#define ACTION_ENTER              1
+#define ACTION_LEAVE              2
+#define ACTION_TURNED_BACK        3
+#define ACTION_AMBIGUOUS          4
+
+// -----------------------------------------------------------------------------
+// Private types
+
+#define PATH_STATE_ENUM(state) PATH_##state,
+enum path_state {
+  PATH_STATES(PATH_STATE_ENUM)
+  PATH_STATE_COUNT
+};
+
+typedef struct {
+  uint8_t next;
+  uint8_t action;
+} path_transition_t;
+
+// -----------------------------------------------------------------------------
+// Private variables
+
+#define T(next, action) { PATH_##next, ACTION_##action }
+#define PATH_TRANSITION_ROW(state, none, left, right, both) \
+  [PATH_##state] = { none, left, right, both },
+static const path_transition_t path_transitions[PATH_STATE_COUNT][4] = {
+  PATH_TRANSITIONS(PATH_TRANSITION_ROW)
+};
+#undef T
+
+#if defined(SL_CATALOG_APP_LOG_PRESENT) && APP_LOG_ENABLE \
+  || defined(SL_CATALOG_RETARGET_STDIO_PRESENT)
+static const char *reject_name[PEOPLE_COUNTING_REJECT_COUNT] = {
+  "turned back",
+  "ambiguous"
+};
+#endif
+
+// -----------------------------------------------------------------------------
+// Private function declarations
+
+static uint8_t get_score(people_counting_baseline_t *baseline,
+                         const people_counting_sample_t *sample,
+                         uint16_t distance_threshold);
+static void filter_reset(people_counting_filter_t *filter);
+static uint16_t filter_add(people_counting_filter_t *filter,
+                           uint16_t value);
+
+// -----------------------------------------------------------------------------
+// Public function definitions
+
+/**************************************************************************//**
+ * Reset a people counting state.
+ *****************************************************************************/
+void people_counting_init(people_counting_t *counting,
+                          uint16_t distance_threshold)
+{
+  memset(counting, 0, sizeof(*counting));
+  counting->distance_threshold[LEFT] = distance_threshold;
+  counting->distance_threshold[RIGHT] = distance_threshold;
+  // we start from state where nobody is any of the zones
+  counting->path_state = PATH_IDLE;
+}
+
+/**************************************************************************//**
+ * Change the distance threshold of a zone.
+ *****************************************************************************/
+void people_counting_set_threshold(people_counting_t *counting,
+                                   uint8_t zone,
+                                   uint16_t distance_threshold)
+{
+  counting->distance_threshold[zone] = distance_threshold;
+}
+
+/**************************************************************************//**
+ * Check whether nobody is in the zones.
+ *****************************************************************************/
+bool people_counting_is_empty(const people_counting_t *counting)
+{
+  return (PATH_IDLE == counting->path_state)
+         && (NOBODY == counting->zone_status[LEFT])
+         && (NOBODY == counting->zone_status[RIGHT]);
+}
+
+/**************************************************************************//**
+ * Add a ranging sample of a zone.
+ *****************************************************************************/
+people_counting_event_t people_counting_process(
+  people_counting_t *counting,
+  const people_counting_sample_t *sample,
+  uint8_t zone)
+{
+  const path_transition_t *transition;
+  people_counting_event_t event = PEOPLE_COUNTING_EVENT_NONE;
+  uint8_t score;
+  uint16_t max_score;
+  uint8_t current_zone_status = NOBODY;
+
+  score = get_score(&counting->baselines[zone],
+                    sample,
+                    counting->distance_threshold[zone]);
+  // Add just picked score to the window of the corresponding zone, the
+  // filter keeps the minimum so it is given the complement
+  max_score = SCORE_MAX - filter_add(&counting->filters[zone],
+                                     SCORE_MAX - score);
+
+  if (max_score >= SCORE_PRESENT) {
+    // Someone is in !
+    current_zone_status = SOMEONE;
+  }
+  if (current_zone_status == counting->zone_status[zone]) {
+    return event;
+  }
+
+  // event in the zone has occured, move the path forward
+  counting->zone_status[zone] = current_zone_status;
+  transition = &path_transitions[counting->path_state]
+               [counting->zone_status[LEFT]
+                | (counting->zone_status[RIGHT] << 1)];
+  counting->path_state = transition->next;
+
+  switch (transition->action) {
+    case ACTION_NONE:
+      return event;
+    case ACTION_ENTER:
+      // People enter the room
+      event = PEOPLE_COUNTING_EVENT_ENTER;
+      break;
+    case ACTION_LEAVE:
+      // People exit the room
+      event = PEOPLE_COUNTING_EVENT_LEAVE;
+      break;
+    case ACTION_TURNED_BACK:
+    case ACTION_AMBIGUOUS:
+      counting->rejects[transition->action - ACTION_TURNED_BACK]++;
+      log_info("Invalid path: %s\r\n",
+               reject_name[transition->action - ACTION_TURNED_BACK]);
+      break;
+  }
+  // restart the filtering in case an entry or exit just found,
+  // and also in case of unexpected path
+  filter_reset(&counting->filters[LEFT]);
+  filter_reset(&counting->filters[RIGHT]);
+
+  return event;
+}
+
+// -----------------------------------------------------------------------------
+// Private function
+
+static uint8_t get_score(people_counting_baseline_t *baseline,
+                         const people_counting_sample_t *sample,
+                         uint16_t distance_threshold)
+{
+  int32_t margin = distance_threshold >> DISTANCE_MARGIN_SHIFT;
+  int32_t signal = (int32_t)sample->signal_per_spad << 4;
+  int32_t ambient = (int32_t)sample->ambient_per_spad << 4;
+  int32_t distance_score;
+  int32_t signal_score = 0;
+  int32_t distance_weight;
+
+  if (!baseline->seeded) {
+    // First sample, the zone is assumed empty. The ambient rate is 0 in a
+    // dark doorway, it can not tell that the baselines are set.
+    baseline->signal = signal;
+    baseline->ambient = ambient;
+    baseline->seeded = true;
+  }
+
+  if (sample->valid) {
+    distance_weight = SCORE_DISTANCE_WEIGHT;
+  } else if ((ambient > (int32_t)baseline->ambient * AMBIENT_RATIO_SUNLIT)
+             && (baseline->holds < HOLD_MAX)) {
+    // The range failed in sunlight, it tells nothing about the zone
+    baseline->holds++;
+    return baseline->score;
+  } else {
+    // Only a strong signal tells that someone is there
+    distance_weight = 0;
+  }
+  baseline->holds = 0;
+
+  // Full score below the threshold, none above, linear in the margin
+  if (margin == 0) {
+    margin = 1;
+  }
+  distance_score = ((int32_t)distance_threshold + margin - sample->distance)
+                   * SCORE_MAX / (2 * margin);
+  if (distance_score < 0) {
+    distance_score = 0;
+  } else if (distance_score > SCORE_MAX) {
+    distance_score = SCORE_MAX;
+  }
+
+  // Someone closer than the floor returns more signal
+  if (baseline->signal) {
+    signal_score = (signal - (int32_t)baseline->signal) * SCORE_MAX
+                   / ((SIGNAL_RATIO_MAX - 1) * (int32_t)baseline->signal);
+    if (signal_score < 0) {
+      signal_score = 0;
+    } else if (signal_score > SCORE_MAX) {
+      signal_score = SCORE_MAX;
+    }
+  }
+
+  baseline->score = (distance_weight * distance_score
+                     + SCORE_SIGNAL_WEIGHT * signal_score)
+                    / (distance_weight + SCORE_SIGNAL_WEIGHT);
+
+  // The baselines follow the empty zone, slowly enough to ignore people
+  if (baseline->score < SCORE_PRESENT) {
+    if (sample->valid) {
+      baseline->signal += (signal - (int32_t)baseline->signal)
+                          >> BASELINE_SHIFT;
+    }
+    baseline->ambient += (ambient - (int32_t)baseline->ambient)
+                         >> BASELINE_SHIFT;
+  }
+  return baseline->score;
+}
+
+static void filter_reset(people_counting_filter_t *filter)
+{
+  filter->sample_count = 0;
+#if (PEOPLE_COUNTING_FILTER_MEDIAN == 0)
+  filter->head = 0;
+  filter->size = 0;
+#endif
+}
+
+#if (PEOPLE_COUNTING_FILTER_MEDIAN == 1)
+static uint16_t filter_add(people_counting_filter_t *filter,
+                           uint16_t value)
+{
+  uint8_t count = filter->sample_count;
+  uint8_t i;
+
+  if (count == PEOPLE_COUNTING_DISTANCES_SIZE) {
+    // Drop the oldest sample from both arrays
+    for (i = 0; filter->sorted[i] != filter->samples[0]; i++) {
+    }
+    count--;
+    memmove(&filter->sorted[i], &filter->sorted[i + 1],
+            (count - i) * sizeof(uint16_t));
+    memmove(&filter->samples[0], &filter->samples[1],
+            count * sizeof(uint16_t));
+  }
+  filter->samples[count] = value;
+  for (i = count; (i > 0) && (filter->sorted[i - 1] > value); i--) {
+    filter->sorted[i] = filter->sorted[i - 1];
+  }
+  filter->sorted[i] = value;
+  filter->sample_count = count + 1;
+
+  return filter->sorted[(count + 1) / 2];
+}
+#else
+static uint16_t filter_add(people_counting_filter_t *filter,
+                           uint16_t value)
+{
+  uint16_t index = filter->sample_count++;
+  uint8_t tail;
+
+  // Samples greater than the new one are never the minimum again
+  while (filter->size) {
+    tail = (filter->head + filter->size - 1) % PEOPLE_COUNTING_DISTANCES_SIZE;
+    if (filter->value[tail] < value) {
+      break;
+    }
+    filter->size--;
+  }
+  // The head sample leaves the window
+  if (filter->size
+      && ((uint16_t)(index - filter->index[filter->head])
+          >= PEOPLE_COUNTING_DISTANCES_SIZE)) {
+    filter->head = (filter->head + 1) % PEOPLE_COUNTING_DISTANCES_SIZE;
+    filter->size--;
+  }
+  tail = (filter->head + filter->size) % PEOPLE_COUNTING_DISTANCES_SIZE;
+  filter->index[tail] = index;
+  filter->value[tail] = value;
+  filter->size++;
+
+  return filter->value[filter->head];
+}
+#endif
+
+/** @} (end group people_counting) */
@@ -0,0 +1,258 @@
+/***************************************************************************//**
+ * @file people_counting_trace.c
+ * @brief Delta encoded ring of people counting samples
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+#include <string.h>
+#include "people_counting_trace.h"
+
+/***************************************************************************//**
+ * @addtogroup people_counting_trace
+ * @brief  People counting sample trace.
+ * @details
+ *   A record is the time since the previous record, the zone with the valid
+ *   flag, the range status, then the distance, signal and ambient rates as
+ *   differences to the previous sample of the zone. Numbers are stored 7 bits
+ *   per byte, the differences in zigzag order, so that an idle zone takes 6
+ *   bytes per sample.
+ * @{
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+// Defines
+
+#define ZONE_MASK                 0x0F
+#define VALID_FLAG                0x10
+#define VARINT_MORE               0x80
+
+// -----------------------------------------------------------------------------
+// Private function declarations
+
+static uint16_t encode(people_counting_trace_state_t *state,
+                       const people_counting_trace_record_t *record,
+                       uint8_t *data);
+static uint16_t decode(const people_counting_trace_t *trace,
+                       uint16_t offset,
+                       people_counting_trace_state_t *state,
+                       people_counting_trace_record_t *record);
+static uint16_t put_varint(uint8_t *data, uint32_t value);
+static uint16_t put_delta(uint8_t *data, uint16_t *last, uint16_t value);
+static uint32_t get_varint(const people_counting_trace_t *trace,
+                           uint16_t *offset);
+static uint16_t get_delta(const people_counting_trace_t *trace,
+                          uint16_t *offset,
+                          uint16_t *last);
+
+// -----------------------------------------------------------------------------
+// Public function definitions
+
+/**************************************************************************//**
+ * Reset a trace.
+ *****************************************************************************/
+void people_counting_trace_init(people_counting_trace_t *trace,
+                                uint8_t *buffer,
+                                uint16_t size)
+{
+  memset(trace, 0, sizeof(*trace));
+  trace->buffer = buffer;
+  trace->size = size;
+}
+
+/**************************************************************************//**
+ * Add a record.
+ *****************************************************************************/
+void people_counting_trace_add(people_counting_trace_t *trace,
+                               const people_counting_trace_record_t *record)
+{
+  uint8_t data[PEOPLE_COUNTING_TRACE_RECORD_MAX];
+  uint16_t length;
+  uint16_t offset;
+  uint16_t i;
+
+  if (trace->size < PEOPLE_COUNTING_TRACE_RECORD_MAX) {
+    return;
+  }
+  length = encode(&trace->last, record, data);
+
+  // Make room by moving the oldest records into the starting state
+  while (trace->used + length > trace->size) {
+    offset = decode(trace, trace->head, &trace->first, NULL);
+    trace->head = (trace->head + offset) % trace->size;
+    trace->used -= offset;
+    trace->dropped++;
+  }
+
+  offset = (trace->head + trace->used) % trace->size;
+  for (i = 0; i < length; i++) {
+    trace->buffer[offset] = data[i];
+    offset = (offset + 1) % trace->size;
+  }
+  trace->used += length;
+}
+
+/**************************************************************************//**
+ * Start reading the records.
+ *****************************************************************************/
+void people_counting_trace_rewind(const people_counting_trace_t *trace,
+                                  people_counting_trace_cursor_t *cursor)
+{
+  cursor->offset = trace->head;
+  cursor->remaining = trace->used;
+  cursor->state = trace->first;
+}
+
+/**************************************************************************//**
+ * Read the next record.
+ *****************************************************************************/
+bool people_counting_trace_read(const people_counting_trace_t *trace,
+                                people_counting_trace_cursor_t *cursor,
+                                people_counting_trace_record_t *record)
+{
+  uint16_t length;
+
+  if (0 == cursor->remaining) {
+    return false;
+  }
+  length = decode(trace, cursor->offset, &cursor->state, record);
+  cursor->offset = (cursor->offset + length) % trace->size;
+  cursor->remaining -= length;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// Private function
+
+static uint16_t encode(people_counting_trace_state_t *state,
+                       const people_counting_trace_record_t *record,
+                       uint8_t *data)
+{
+  uint8_t zone = record->zone & ZONE_MASK;
+  uint16_t length;
+
+  length = put_varint(data, record->time_ms - state->time_ms);
+  state->time_ms = record->time_ms;
+  data[length++] = zone | (record->sample.valid ? VALID_FLAG : 0);
+  data[length++] = record->status;
+  length += put_delta(&data[length],
+                      &state->distance[zone],
+                      record->sample.distance);
+  length += put_delta(&data[length],
+                      &state->signal[zone],
+                      record->sample.signal_per_spad);
+  length += put_delta(&data[length],
+                      &state->ambient[zone],
+                      record->sample.ambient_per_spad);
+  return length;
+}
+
+static uint16_t decode(const people_counting_trace_t *trace,
+                       uint16_t offset,
+                       people_counting_trace_state_t *state,
+                       people_counting_trace_record_t *record)
+{
+  people_counting_trace_record_t dropped;
+  uint16_t start = offset;
+  uint8_t flags;
+  uint8_t zone;
+
+  if (NULL == record) {
+    record = &dropped;
+  }
+  state->time_ms += get_varint(trace, &offset);
+  record->time_ms = state->time_ms;
+  flags = trace->buffer[offset];
+  offset = (offset + 1) % trace->size;
+  zone = flags & ZONE_MASK;
+  record->zone = zone;
+  record->sample.valid = (flags & VALID_FLAG) != 0;
+  record->status = trace->buffer[offset];
+  offset = (offset + 1) % trace->size;
+  record->sample.distance = get_delta(trace, &offset, &state->distance[zone]);
+  record->sample.signal_per_spad = get_delta(trace,
+                                             &offset,
+                                             &state->signal[zone]);
+  record->sample.ambient_per_spad = get_delta(trace,
+                                              &offset,
+                                              &state->ambient[zone]);
+
+  return (offset + trace->size - start) % trace->size;
+}
+
+static uint16_t put_varint(uint8_t *data, uint32_t value)
+{
+  uint16_t length = 0;
+
+  while (value >= VARINT_MORE) {
+    data[length++] = (uint8_t)(value | VARINT_MORE);
+    value >>= 7;
+  }
+  data[length++] = (uint8_t)value;
+  return length;
+}
+
+static uint16_t put_delta(uint8_t *data, uint16_t *last, uint16_t value)
+{
+  int16_t delta = (int16_t)(value - *last);
+
+  *last = value;
+  // Zigzag: small differences of both signs take one byte
+  return put_varint(data, ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 15));
+}
+
+static uint32_t get_varint(const people_counting_trace_t *trace,
+                           uint16_t *offset)
+{
+  uint32_t value = 0;
+  uint8_t shift = 0;
+  uint8_t byte;
+
+  do {
+    byte = trace->buffer[*offset];
+    *offset = (*offset + 1) % trace->size;
+    value |= (uint32_t)(byte & ~VARINT_MORE) << shift;
+    shift += 7;
+  } while (byte & VARINT_MORE);
+  return value;
+}
+
+static uint16_t get_delta(const people_counting_trace_t *trace,
+                          uint16_t *offset,
+                          uint16_t *last)
+{
+  uint32_t zigzag = get_varint(trace, offset);
+
+  *last += (uint16_t)((zigzag >> 1) ^ (0 - (zigzag & 1)));
+  return *last;
+}
+
+/** @} (end group people_counting_trace) */
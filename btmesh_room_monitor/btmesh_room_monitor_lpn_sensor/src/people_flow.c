@@ -0,0 +1,143 @@
+/***************************************************************************//**
+ * @file people_flow.c
+ * @brief People flow statistics
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+#include <string.h>
+#include "people_flow.h"
+
+/***************************************************************************//**
+ * @addtogroup people_flow
+ * @brief  People flow statistics.
+ * @details
+ *   The statistics are updated on each pass and marshaled in the sensor data
+ *   format of the sensor server, so that they can be published along with
+ *   the people count.
+ * @{
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+// Defines
+
+#define PROPERTY_HEADER_SIZE      3
+#define MS_PER_HOUR               3600000UL
+
+// -----------------------------------------------------------------------------
+// Private function declarations
+
+static uint8_t put_property(uint8_t *data,
+                            uint16_t property_id,
+                            uint32_t value,
+                            uint8_t len);
+
+// -----------------------------------------------------------------------------
+// Public function definitions
+
+/**************************************************************************//**
+ * Reset the statistics.
+ *****************************************************************************/
+void people_flow_init(people_flow_t *flow)
+{
+  memset(flow, 0, sizeof(*flow));
+}
+
+/**************************************************************************//**
+ * Account for someone going through the door.
+ *****************************************************************************/
+void people_flow_add(people_flow_t *flow, bool enter, uint16_t count)
+{
+  if (enter) {
+    flow->entries++;
+  } else {
+    flow->exits++;
+  }
+  if (flow->interval_passes < UINT16_MAX) {
+    flow->interval_passes++;
+  }
+  if (count > flow->peak_count) {
+    flow->peak_count = count;
+  }
+}
+
+/**************************************************************************//**
+ * End the current interval and update the flow rate.
+ *****************************************************************************/
+void people_flow_close_interval(people_flow_t *flow, uint32_t interval_ms)
+{
+  uint64_t rate = 0;
+
+  if (interval_ms) {
+    rate = (uint64_t)flow->interval_passes * MS_PER_HOUR / interval_ms;
+  }
+  flow->flow_rate = (rate > UINT16_MAX) ? UINT16_MAX : (uint16_t)rate;
+  flow->interval_passes = 0;
+}
+
+/**************************************************************************//**
+ * Marshal the statistics as sensor data.
+ *****************************************************************************/
+uint8_t people_flow_to_sensor_data(const people_flow_t *flow, uint8_t *data)
+{
+  uint8_t len = 0;
+
+  len += put_property(&data[len], PEOPLE_FLOW_PROPERTY_ENTRIES,
+                      flow->entries, 4);
+  len += put_property(&data[len], PEOPLE_FLOW_PROPERTY_EXITS,
+                      flow->exits, 4);
+  len += put_property(&data[len], PEOPLE_FLOW_PROPERTY_FLOW_RATE,
+                      flow->flow_rate, 2);
+  len += put_property(&data[len], PEOPLE_FLOW_PROPERTY_PEAK_COUNT,
+                      flow->peak_count, 2);
+  return len;
+}
+
+// -----------------------------------------------------------------------------
+// Private function
+
+static uint8_t put_property(uint8_t *data,
+                            uint16_t property_id,
+                            uint32_t value,
+                            uint8_t len)
+{
+  uint8_t i;
+
+  data[0] = (uint8_t)property_id;
+  data[1] = (uint8_t)(property_id >> 8);
+  data[2] = len;
+  for (i = 0; i < len; i++) {
+    data[PROPERTY_HEADER_SIZE + i] = (uint8_t)(value >> (8 * i));
+  }
+  return PROPERTY_HEADER_SIZE + len;
+}
+
+/** @} (end group people_flow) */
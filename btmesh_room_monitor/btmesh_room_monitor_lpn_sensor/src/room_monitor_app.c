@@ -34,21 +34,28 @@
  * Silicon Labs may update projects from time to time.
  ******************************************************************************/
 #include <stdio.h>
+#include <string.h>
 #include "em_common.h"
 #include "app_assert.h"
 #include "sl_bluetooth.h"
+#include "sl_btmesh_api.h"
 #include "gatt_db.h"
 #ifdef SL_CATALOG_SIMPLE_LED_PRESENT
 #include "sl_simple_led_instances.h"
 #endif
 #include "sl_simple_button_instances.h"
+#include "sl_simple_button.h"
+#include "nvm3_default.h"
 
 #include "sl_btmesh_sensor_people_count.h"
 #include "sl_btmesh_sensor_people_count_config.h"
 
 #include "app_display.h"
 #include "app.h"
+#include "vl53l1x_config.h"
 #include "vl53l1x_app.h"
+#include "i2c_bus_arbiter.h"
+#include "people_flow.h"
 #include "room_monitor_app.h"
 
 // -----------------------------------------------------------------------------
@@ -94,29 +101,124 @@
 #define MAX_DISTANCE                    (2700)
 #define DISTANCE_THRESHOLD              (1600)
 #define TIMING_BUDGET                   (33)
+// Distance of the grey target of the offset and crosstalk calibration,
+// 0 when the sensor is not calibrated with a target
+#define CALIBRATION_TARGET_DISTANCE     (0)
+#define CALIBRATION_LONG_PRESS_MS       (2000)
+#define TRACE_DUMP_PRESS_MS             (5000)
+// The count changes are applied to the sensor server, which publishes them,
+// once no other change came for COUNT_PUBLISH_MIN_INTERVAL_MS but at the
+// latest COUNT_PUBLISH_MAX_STALENESS_MS after the first one. 0 applies every
+// change at once.
+#define COUNT_PUBLISH_MIN_INTERVAL_MS   (2000)
+#define COUNT_PUBLISH_MAX_STALENESS_MS  (10000)
+// A count left after RECONCILE_EMPTY_MS without anyone in the zones is only
+// corrected when it is not trusted: some paths were rejected as ambiguous or
+// some leaves were clamped at 0 since the previous correction. It is then
+// zeroed when it is at most RECONCILE_RESIDUAL_COUNT, decreased by one else.
+// People staying in the room do not cross the zones, a trusted count is kept.
+#define RECONCILE_EMPTY_MS              (30 * 60 * 1000)
+#define RECONCILE_RESIDUAL_COUNT        (2)
+// The count and the flow statistics are stored in NVM3 once they did not
+// change for COUNT_STORE_SETTLE_MS but at the latest COUNT_STORE_MAX_DELAY_MS
+// after the first change, with at most COUNT_STORE_MAX_PER_HOUR writes to
+// spare the flash
+#define COUNT_NVM3_KEY                  (0x0101)
+#define COUNT_STORE_VERSION             (1)
+#define COUNT_STORE_SETTLE_MS           (60 * 1000)
+#define COUNT_STORE_MAX_DELAY_MS        (10 * 60 * 1000)
+#define COUNT_STORE_MAX_PER_HOUR        (6)
+#define COUNT_STORE_REFILL_MS           (60 * 60 * 1000 \
+                                         / COUNT_STORE_MAX_PER_HOUR)
+// Period of the flow rate and of the publication of the flow statistics
+#define FLOW_INTERVAL_MS                (15 * 60 * 1000)
+
+// Sensor status publication, as done by the sensor server
+#define PUBLISH_ADDRESS                 (0x0000)
+#define SENSOR_ELEMENT                  (0)
+#define IGNORED                         (0)
+#define NO_FLAGS                        (0)
 
 #define PEOPLE_COUNTING_BUTTON_EVENT    (1<<0)
 #define PEOPLE_COUNTING_SAMPLING_EVENT  (1<<1)
 #define PEOPLE_COUNTING_EVENT           (1<<2)
+#define PEOPLE_COUNTING_PUBLISH_EVENT   (1<<3)
+#define PEOPLE_COUNTING_FLOW_EVENT      (1<<4)
+#define PEOPLE_COUNTING_STORE_EVENT     (1<<5)
+
+// Count stored in NVM3
+typedef struct {
+  uint8_t version;
+  uint16_t people_count;
+  uint16_t peak_count;
+  uint32_t entries;
+  uint32_t exits;
+} room_monitor_stored_count_t;
 
 // -----------------------------------------------------------------------------
 // Private variables
-static uint32_t people_entered_so_far;
+static people_flow_t people_flow;
 
 static sl_sleeptimer_timer_handle_t oled_timer;
 static sl_sleeptimer_timer_handle_t people_counting_timer;
+static sl_sleeptimer_timer_handle_t count_publish_timer;
+static sl_sleeptimer_timer_handle_t flow_timer;
+static sl_sleeptimer_timer_handle_t count_store_timer;
+
+// Net count change not applied to the sensor server yet
+static int32_t count_pending = 0;
+static bool count_window_open = false;
+static uint32_t count_window_tick;
+
+// Start of the empty doorway period, ambiguous paths and clamped leaves at
+// the last correction
+static uint32_t reconcile_tick;
+static uint32_t reconcile_ambiguous;
+static uint32_t reconcile_clamped;
+static room_monitor_correction_stats_t correction_stats;
+
+// Writes left in the budget, time of the last budget refill
+static uint8_t count_store_budget;
+static uint32_t count_store_tick;
+// Changes not stored yet, time of the first one
+static bool count_store_window_open = false;
+static uint32_t count_store_window_tick;
 
 static uint16_t startup_delay_ms = 0;
+static bool sampling_started = false;
+static volatile uint32_t button_press_ms = 0;
 
 // -----------------------------------------------------------------------------
 // Private function declarations
 
 static void people_counting_button_handler(void);
 static void people_counting_event_handler(void);
+static void log_bus_statistics(void);
+static uint16_t get_people_count(void);
+static void queue_people_count_change(int8_t change);
+static void publish_people_count(void);
+static void apply_people_count(uint16_t count);
+static void reconcile_people_count(void);
+static void load_people_count(void);
+static void schedule_count_store(void);
+static void store_people_count(void);
+static void publish_people_flow(void);
+static void publish_sensor_health(void);
+static void people_counting_publish_callback(
+    sl_sleeptimer_timer_handle_t *timer, void *data);
+static void people_counting_flow_callback(
+    sl_sleeptimer_timer_handle_t *timer, void *data);
+static void people_counting_store_callback(
+    sl_sleeptimer_timer_handle_t *timer, void *data);
 static void people_counting_oled_display_callback(
     sl_sleeptimer_timer_handle_t *timer, void *data);
+#if (VL53L1X_CONFIG_INT_ENABLE == 1)
+static void people_counting_sensor_start_callback(
+    sl_sleeptimer_timer_handle_t *timer, void *data);
+#else
 static void people_counting_sensor_sampling_callback(
     sl_sleeptimer_timer_handle_t *timer, void *data);
+#endif
 
 
 // -----------------------------------------------------------------------------
@@ -127,17 +229,41 @@ static void people_counting_sensor_sampling_callback(
  *****************************************************************************/
 void room_monitor_app_init(void)
 {
-  people_entered_so_far = 0;
+  sl_status_t sc;
+
+  people_flow_init(&people_flow);
+  count_pending = 0;
+  count_window_open = false;
+  reconcile_tick = sl_sleeptimer_get_tick_count();
+  reconcile_ambiguous = 0;
+  reconcile_clamped = 0;
+  memset(&correction_stats, 0, sizeof(correction_stats));
+  count_store_budget = COUNT_STORE_MAX_PER_HOUR;
+  count_store_tick = reconcile_tick;
+  count_store_window_open = false;
 
   vl53l1x_app_init(MIN_DISTANCE,
                   MAX_DISTANCE,
                   DISTANCE_THRESHOLD,
                   TIMING_BUDGET);
+  // Measure the empty doorway on the first start of the installation
+  if (!vl53l1x_app_is_calibrated()) {
+    vl53l1x_app_start_calibration();
+  }
 
   log_info("OLED initialized\r\n");
   app_display_init();
 
-  sl_btmesh_set_people_count(0);
+  // Restore the count of the previous run before the sampling starts
+  load_people_count();
+
+  sc = sl_sleeptimer_start_periodic_timer_ms(&flow_timer,
+                                             FLOW_INTERVAL_MS,
+                                             people_counting_flow_callback,
+                                             NULL,
+                                             0,
+                                             0);
+  app_assert_status(sc);
 }
 
 /**************************************************************************//**
@@ -149,6 +275,7 @@ void room_monitor_app_start_sampling(uint16_t delay_ms)
   sl_status_t sc;
 
   startup_delay_ms = delay_ms;
+  sampling_started = true;
   if(!delay_ms) {
     delay_ms = 1;
   }
@@ -156,12 +283,22 @@ void room_monitor_app_start_sampling(uint16_t delay_ms)
   app_assert_status(sc);
   // Create sampling and calculate people count periodic timer
   if(!running) {
+#if (VL53L1X_CONFIG_INT_ENABLE == 1)
+    // Samples are signaled by the data ready interrupt after the delay
+    sc = sl_sleeptimer_start_timer_ms(&people_counting_timer,
+                                      delay_ms,
+                                      people_counting_sensor_start_callback,
+                                      NULL,
+                                      0,
+                                      0);
+#else
     sc = sl_sleeptimer_start_periodic_timer_ms( &people_counting_timer,
                                                 delay_ms,
                                                 people_counting_sensor_sampling_callback,
                                                 NULL,
                                                 0,
                                                 0);
+#endif
     app_assert_status(sc);
   }
 
@@ -194,6 +331,30 @@ void room_monitor_app_stop_sampling(void)
     sc = sl_sleeptimer_stop_timer(&people_counting_timer);
     app_assert_status(sc);
   }
+  vl53l1x_app_stop_data_ready_interrupt();
+  sampling_started = false;
+}
+
+/**************************************************************************//**
+ * Set People Count.
+ *****************************************************************************/
+void room_monitor_app_set_people_count(uint16_t count)
+{
+  if (count >= (uint16_t)SL_BTMESH_SENSOR_PEOPLE_COUNT_VALUE_IS_NOT_KNOWN) {
+    count = (uint16_t)SL_BTMESH_SENSOR_PEOPLE_COUNT_VALUE_IS_NOT_KNOWN - 1;
+  }
+  correction_stats.set_count++;
+  apply_people_count(count);
+  log_info("People Count=%d set\r\n", count);
+}
+
+/**************************************************************************//**
+ * Get Correction Stats.
+ *****************************************************************************/
+void room_monitor_app_get_correction_stats(
+  room_monitor_correction_stats_t *stats)
+{
+  *stats = correction_stats;
 }
 
 /**************************************************************************//**
@@ -206,6 +367,9 @@ void people_counting_process_evt_external_signal(uint32_t extsignals)
   }
 
   if (extsignals & PEOPLE_COUNTING_SAMPLING_EVENT) {
+#if (VL53L1X_CONFIG_INT_ENABLE == 1)
+    vl53l1x_app_process_sampling_data();
+#else
     if(startup_delay_ms) {
       startup_delay_ms = 0;
       // Create sampling and calculate people count periodic timer
@@ -219,11 +383,30 @@ void people_counting_process_evt_external_signal(uint32_t extsignals)
     else {
       vl53l1x_app_process_sampling_data();
     }
+#endif
   }
 
   if (extsignals & PEOPLE_COUNTING_EVENT) {
+    if (sampling_started) {
+      vl53l1x_app_check_health();
+    }
+    reconcile_people_count();
     people_counting_event_handler();
   }
+
+  if (extsignals & PEOPLE_COUNTING_PUBLISH_EVENT) {
+    publish_people_count();
+  }
+
+  if (extsignals & PEOPLE_COUNTING_STORE_EVENT) {
+    store_people_count();
+  }
+
+  if (extsignals & PEOPLE_COUNTING_FLOW_EVENT) {
+    people_flow_close_interval(&people_flow, FLOW_INTERVAL_MS);
+    publish_people_flow();
+    publish_sensor_health();
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -233,29 +416,84 @@ void vl53l1x_app_on_event(enum VL53L1X_APP_EVENT evt)
 {
   switch(evt) {
     case VL53L1X_APP_EVENT_SOMEONE_ENTER:
-      sl_btmesh_people_count_increase();
-      people_entered_so_far++;
-      log_info("Someone In, People Count=%d\r\n", sl_btmesh_get_people_count());
+      queue_people_count_change(1);
+      people_flow_add(&people_flow, true, get_people_count());
+      log_info("Someone In, People Count=%d\r\n", get_people_count());
       break;
     case VL53L1X_APP_EVENT_SOMEONE_LEAVE:
-      sl_btmesh_people_count_decrease();
-      log_info("Someone Out, People Count=%d\r\n", sl_btmesh_get_people_count());
+      queue_people_count_change(-1);
+      people_flow_add(&people_flow, false, get_people_count());
+      log_info("Someone Out, People Count=%d\r\n", get_people_count());
+      break;
+    case VL53L1X_APP_EVENT_CALIBRATED:
+      log_info("Calibration done\r\n");
+      break;
+    case VL53L1X_APP_EVENT_HEALTH_CHANGED:
+      log_info("Sensor health=%d\r\n", vl53l1x_app_get_health());
+      publish_sensor_health();
       break;
   }
 }
 
+/***************************************************************************//**
+ * Callback on BTN0 change, in interrupt context.
+ ******************************************************************************/
+void sl_button_on_change(const sl_button_t *handle)
+{
+  static uint32_t press_tick;
+
+  if (&sl_button_btn0 != handle) {
+    return;
+  }
+  if (SL_SIMPLE_BUTTON_PRESSED == sl_button_get_state(handle)) {
+    press_tick = sl_sleeptimer_get_tick_count();
+  } else {
+    button_press_ms = sl_sleeptimer_tick_to_ms(sl_sleeptimer_get_tick_count()
+                                               - press_tick);
+    sl_bt_external_signal(PEOPLE_COUNTING_BUTTON_EVENT);
+  }
+}
+
+void vl53l1x_app_on_data_ready(void)
+{
+  sl_bt_external_signal(PEOPLE_COUNTING_SAMPLING_EVENT);
+}
+
 // -----------------------------------------------------------------------------
 // Private function
 
 static void people_counting_button_handler(void)
 {
+  if (button_press_ms >= TRACE_DUMP_PRESS_MS) {
+    // Very long press: print the last samples for an offline replay
+    vl53l1x_app_dump_trace();
+    return;
+  }
+  if (button_press_ms < CALIBRATION_LONG_PRESS_MS) {
+    // Short press: calibrate the zone thresholds on the empty doorway
+    vl53l1x_app_start_calibration();
+    return;
+  }
+#if (CALIBRATION_TARGET_DISTANCE > 0)
+  // Long press: calibrate offset and crosstalk on the target
+  bool restart = sampling_started;
+  sl_status_t sc;
 
+  room_monitor_app_stop_sampling();
+  sc = vl53l1x_app_calibrate_offset_and_xtalk(CALIBRATION_TARGET_DISTANCE);
+  if (SL_STATUS_OK != sc) {
+    log_error("Offset and xtalk calibration failed: 0x%x\r\n", sc);
+  }
+  if (restart) {
+    room_monitor_app_start_sampling(0);
+  }
+#endif
 }
 
 static void people_counting_event_handler(void)
 {
   static uint16_t last_people_count = (uint16_t)-1;
-  uint16_t current_people_count = sl_btmesh_get_people_count();
+  uint16_t current_people_count = get_people_count();
 
   // Only display & notify people count when their value is changed
   if ( last_people_count != current_people_count) {
@@ -263,9 +501,368 @@ static void people_counting_event_handler(void)
 
     // Display people count on oled screen
     app_display_show_people_count(current_people_count);
+    log_info("Rejected paths: turned back %lu, ambiguous %lu\r\n",
+             (unsigned long)vl53l1x_app_get_rejected_path_count(
+               PEOPLE_COUNTING_REJECT_TURNED_BACK),
+             (unsigned long)vl53l1x_app_get_rejected_path_count(
+               PEOPLE_COUNTING_REJECT_AMBIGUOUS));
+    log_info("Corrections: zeroed %lu, decayed %lu, clamped %lu, set %lu\r\n",
+             (unsigned long)correction_stats.zeroed,
+             (unsigned long)correction_stats.decayed,
+             (unsigned long)correction_stats.clamped,
+             (unsigned long)correction_stats.set_count);
+    log_bus_statistics();
+  }
+}
+
+/***************************************************************************//**
+ * Count including the changes not applied to the sensor server yet.
+ ******************************************************************************/
+static uint16_t get_people_count(void)
+{
+  // The pending changes are saturated when they are queued
+  return (uint16_t)((int32_t)sl_btmesh_get_people_count() + count_pending);
+}
+
+/***************************************************************************//**
+ * Add an entry or a leave to the coalescing window.
+ ******************************************************************************/
+static void queue_people_count_change(int8_t change)
+{
+  uint32_t delay_ms = COUNT_PUBLISH_MIN_INTERVAL_MS;
+  uint32_t open_ms;
+  uint16_t count = get_people_count();
+  sl_status_t sc;
+
+  // Someone went through, the doorway was not empty
+  reconcile_tick = sl_sleeptimer_get_tick_count();
+  // The flow statistics change even when the count does not
+  schedule_count_store();
+  // Same saturation as the increase and decrease of the people count
+  if ((change < 0) && !count) {
+    // More leaves than entries, the count was too low
+    correction_stats.clamped++;
+    return;
+  }
+  if ((change > 0)
+      && (count >= (uint16_t)SL_BTMESH_SENSOR_PEOPLE_COUNT_VALUE_IS_NOT_KNOWN
+          - 1)) {
+    return;
+  }
+  count_pending += change;
+  if (!delay_ms) {
+    publish_people_count();
+    return;
+  }
+  if (!count_window_open) {
+    count_window_open = true;
+    count_window_tick = sl_sleeptimer_get_tick_count();
+  }
+  // Each change pushes the publication back, up to the maximum staleness
+  open_ms = sl_sleeptimer_tick_to_ms(sl_sleeptimer_get_tick_count()
+                                     - count_window_tick);
+  if (open_ms >= COUNT_PUBLISH_MAX_STALENESS_MS) {
+    publish_people_count();
+    return;
+  }
+  if (delay_ms > COUNT_PUBLISH_MAX_STALENESS_MS - open_ms) {
+    delay_ms = COUNT_PUBLISH_MAX_STALENESS_MS - open_ms;
+  }
+  sc = sl_sleeptimer_restart_timer_ms(&count_publish_timer,
+                                      delay_ms,
+                                      people_counting_publish_callback,
+                                      NULL,
+                                      0,
+                                      0);
+  app_assert_status(sc);
+}
+
+/***************************************************************************//**
+ * Apply the net change of the window to the sensor server.
+ ******************************************************************************/
+static void publish_people_count(void)
+{
+  bool running;
+  sl_status_t sc;
+
+  sc = sl_sleeptimer_is_timer_running(&count_publish_timer, &running);
+  app_assert_status(sc);
+  if (running) {
+    sc = sl_sleeptimer_stop_timer(&count_publish_timer);
+    app_assert_status(sc);
+  }
+  count_window_open = false;
+  // Nothing is published when the people who came in went out again
+  if (!count_pending) {
+    return;
+  }
+  sl_btmesh_set_people_count(get_people_count());
+  count_pending = 0;
+  log_info("People Count=%d published\r\n", sl_btmesh_get_people_count());
+}
+
+/***************************************************************************//**
+ * Publish the flow statistics as sensor status of their own properties.
+ ******************************************************************************/
+static void publish_people_flow(void)
+{
+  uint8_t sensor_data[PEOPLE_FLOW_SENSOR_DATA_SIZE];
+  uint8_t len;
+  sl_status_t sc;
+
+  len = people_flow_to_sensor_data(&people_flow, sensor_data);
+  sc = sl_btmesh_sensor_server_send_status(PUBLISH_ADDRESS,
+                                           SENSOR_ELEMENT,
+                                           IGNORED,
+                                           NO_FLAGS,
+                                           len,
+                                           sensor_data);
+  if (SL_STATUS_OK != sc) {
+    log_error("Flow statistics publication failed: 0x%lx\r\n",
+              (unsigned long)sc);
+    return;
   }
+  log_info("Flow: entries %lu, exits %lu, %u per hour, peak %u\r\n",
+           (unsigned long)people_flow.entries,
+           (unsigned long)people_flow.exits,
+           people_flow.flow_rate,
+           people_flow.peak_count);
 }
 
+/***************************************************************************//**
+ * Replace the count, dropping the changes not applied yet.
+ ******************************************************************************/
+static void apply_people_count(uint16_t count)
+{
+  count_pending = 0;
+  // Closes the coalescing window
+  publish_people_count();
+  sl_btmesh_set_people_count(count);
+  schedule_count_store();
+  reconcile_tick = sl_sleeptimer_get_tick_count();
+  reconcile_ambiguous = vl53l1x_app_get_rejected_path_count(
+    PEOPLE_COUNTING_REJECT_AMBIGUOUS);
+  reconcile_clamped = correction_stats.clamped;
+}
+
+/***************************************************************************//**
+ * Correct the count drift after a long period without anyone in the zones.
+ ******************************************************************************/
+static void reconcile_people_count(void)
+{
+  uint32_t now = sl_sleeptimer_get_tick_count();
+  uint16_t count = get_people_count();
+  uint32_t ambiguous;
+
+  if (!sampling_started || !vl53l1x_app_is_doorway_empty()) {
+    reconcile_tick = now;
+    return;
+  }
+  if (sl_sleeptimer_tick_to_ms(now - reconcile_tick) < RECONCILE_EMPTY_MS) {
+    return;
+  }
+  reconcile_tick = now;
+  if (!count) {
+    return;
+  }
+  ambiguous = vl53l1x_app_get_rejected_path_count(
+    PEOPLE_COUNTING_REJECT_AMBIGUOUS);
+  if ((ambiguous == reconcile_ambiguous)
+      && (correction_stats.clamped == reconcile_clamped)) {
+    // Every pass was counted, the people are still in the room
+    return;
+  }
+  // Some passes were not counted, the count is not trusted
+  if (count <= RECONCILE_RESIDUAL_COUNT) {
+    // Most likely missed exits
+    correction_stats.zeroed++;
+    log_info("People Count=%d zeroed after an empty period\r\n", count);
+    apply_people_count(0);
+  } else {
+    correction_stats.decayed++;
+    log_info("People Count=%d decreased after an empty period\r\n", count);
+    apply_people_count(count - 1);
+  }
+}
+
+/***************************************************************************//**
+ * Restore the count and the statistics, 0 if none are stored.
+ ******************************************************************************/
+static void load_people_count(void)
+{
+  room_monitor_stored_count_t stored;
+  uint32_t type;
+  size_t len;
+  Ecode_t ec;
+
+  ec = nvm3_getObjectInfo(nvm3_defaultHandle, COUNT_NVM3_KEY, &type, &len);
+  if ((ECODE_NVM3_OK == ec)
+      && (NVM3_OBJECTTYPE_DATA == type)
+      && (sizeof(stored) == len)) {
+    ec = nvm3_readData(nvm3_defaultHandle,
+                       COUNT_NVM3_KEY,
+                       &stored,
+                       sizeof(stored));
+  } else {
+    ec = ECODE_NVM3_ERR_KEY_NOT_FOUND;
+  }
+  if ((ECODE_NVM3_OK != ec) || (COUNT_STORE_VERSION != stored.version)) {
+    sl_btmesh_set_people_count(0);
+    return;
+  }
+  sl_btmesh_set_people_count(stored.people_count);
+  people_flow.entries = stored.entries;
+  people_flow.exits = stored.exits;
+  people_flow.peak_count = stored.peak_count;
+  log_info("People Count=%d restored\r\n", stored.people_count);
+}
+
+/***************************************************************************//**
+ * Store the count once it settled, or once it waited for the maximum delay.
+ ******************************************************************************/
+static void schedule_count_store(void)
+{
+  uint32_t delay_ms = COUNT_STORE_SETTLE_MS;
+  uint32_t open_ms;
+  sl_status_t sc;
+
+  if (!count_store_window_open) {
+    count_store_window_open = true;
+    count_store_window_tick = sl_sleeptimer_get_tick_count();
+  }
+  // Each change pushes the write back, up to the maximum delay
+  open_ms = sl_sleeptimer_tick_to_ms(sl_sleeptimer_get_tick_count()
+                                     - count_store_window_tick);
+  if (open_ms >= COUNT_STORE_MAX_DELAY_MS) {
+    store_people_count();
+    return;
+  }
+  if (delay_ms > COUNT_STORE_MAX_DELAY_MS - open_ms) {
+    delay_ms = COUNT_STORE_MAX_DELAY_MS - open_ms;
+  }
+  sc = sl_sleeptimer_restart_timer_ms(&count_store_timer,
+                                      delay_ms,
+                                      people_counting_store_callback,
+                                      NULL,
+                                      0,
+                                      0);
+  app_assert_status(sc);
+}
+
+/***************************************************************************//**
+ * Write the count and the statistics, or wait for the write budget.
+ ******************************************************************************/
+static void store_people_count(void)
+{
+  room_monitor_stored_count_t stored;
+  uint32_t now = sl_sleeptimer_get_tick_count();
+  uint32_t elapsed_ms = sl_sleeptimer_tick_to_ms(now - count_store_tick);
+  uint32_t refill = elapsed_ms / COUNT_STORE_REFILL_MS;
+  Ecode_t ec;
+  sl_status_t sc;
+
+  if (refill) {
+    count_store_tick = now;
+    elapsed_ms = 0;
+    refill += count_store_budget;
+    count_store_budget = (refill > COUNT_STORE_MAX_PER_HOUR)
+                         ? COUNT_STORE_MAX_PER_HOUR : (uint8_t)refill;
+  }
+  if (!count_store_budget) {
+    // Retry when the next write is allowed
+    sc = sl_sleeptimer_restart_timer_ms(&count_store_timer,
+                                        COUNT_STORE_REFILL_MS - elapsed_ms,
+                                        people_counting_store_callback,
+                                        NULL,
+                                        0,
+                                        0);
+    app_assert_status(sc);
+    return;
+  }
+  count_store_budget--;
+  count_store_window_open = false;
+
+  memset(&stored, 0, sizeof(stored));
+  stored.version = COUNT_STORE_VERSION;
+  stored.people_count = get_people_count();
+  stored.peak_count = people_flow.peak_count;
+  stored.entries = people_flow.entries;
+  stored.exits = people_flow.exits;
+  ec = nvm3_writeData(nvm3_defaultHandle,
+                      COUNT_NVM3_KEY,
+                      &stored,
+                      sizeof(stored));
+  if (ECODE_NVM3_OK != ec) {
+    log_error("People count store failed: 0x%lx\r\n", (unsigned long)ec);
+  }
+}
+
+/***************************************************************************//**
+ * Publish the health of the sensors so that a failed doorway is noticed.
+ ******************************************************************************/
+static void publish_sensor_health(void)
+{
+  uint8_t sensor_data[4];
+  sl_status_t sc;
+
+  sensor_data[0] = (uint8_t)ROOM_MONITOR_HEALTH_PROPERTY_ID;
+  sensor_data[1] = (uint8_t)(ROOM_MONITOR_HEALTH_PROPERTY_ID >> 8);
+  sensor_data[2] = 1;
+  sensor_data[3] = (uint8_t)vl53l1x_app_get_health();
+  sc = sl_btmesh_sensor_server_send_status(PUBLISH_ADDRESS,
+                                           SENSOR_ELEMENT,
+                                           IGNORED,
+                                           NO_FLAGS,
+                                           sizeof(sensor_data),
+                                           sensor_data);
+  if (SL_STATUS_OK != sc) {
+    log_error("Sensor health publication failed: 0x%lx\r\n",
+              (unsigned long)sc);
+  }
+}
+
+static void log_bus_statistics(void)
+{
+  static const char *client_name[I2C_BUS_CLIENT_COUNT] = { "sensor",
+                                                           "display" };
+  i2c_bus_arbiter_stats_t stats;
+  uint32_t frequency = sl_sleeptimer_get_timer_frequency();
+  uint8_t client;
+
+  // Unused when the logging is disabled
+  (void) client_name;
+  (void) frequency;
+  for (client = 0; client < I2C_BUS_CLIENT_COUNT; client++) {
+    i2c_bus_arbiter_get_stats((i2c_bus_client_t)client, &stats);
+    if (!stats.grants) {
+      continue;
+    }
+    log_info("I2C %s: grants %lu, contentions %lu, wait avg %lu us, "
+             "wait max %lu us, hold max %lu us\r\n",
+             client_name[client],
+             (unsigned long)stats.grants,
+             (unsigned long)stats.contentions,
+             (unsigned long)((uint64_t)stats.wait_total * 1000000
+                             / stats.grants / frequency),
+             (unsigned long)((uint64_t)stats.wait_max * 1000000 / frequency),
+             (unsigned long)((uint64_t)stats.hold_max * 1000000 / frequency));
+  }
+}
+
+#if (VL53L1X_CONFIG_INT_ENABLE == 1)
+/***************************************************************************//**
+ * Callback on end of the startup delay.
+ ******************************************************************************/
+static void people_counting_sensor_start_callback(
+    sl_sleeptimer_timer_handle_t *timer, void *data)
+{
+  (void) timer;
+  (void) data;
+  vl53l1x_app_start_data_ready_interrupt();
+  // Catch a data ready that was asserted before the interrupt was enabled
+  sl_bt_external_signal(PEOPLE_COUNTING_SAMPLING_EVENT);
+}
+#else
 /***************************************************************************//**
  * Callback on timer period.
  ******************************************************************************/
@@ -276,6 +873,40 @@ static void people_counting_sensor_sampling_callback(
   (void) data;
   sl_bt_external_signal(PEOPLE_COUNTING_SAMPLING_EVENT);
 }
+#endif
+
+/***************************************************************************//**
+ * Callback on end of the count coalescing window.
+ ******************************************************************************/
+static void people_counting_publish_callback(
+    sl_sleeptimer_timer_handle_t *timer, void *data)
+{
+  (void) timer;
+  (void) data;
+  sl_bt_external_signal(PEOPLE_COUNTING_PUBLISH_EVENT);
+}
+
+/***************************************************************************//**
+ * Callback on end of the flow interval.
+ ******************************************************************************/
+static void people_counting_flow_callback(
+    sl_sleeptimer_timer_handle_t *timer, void *data)
+{
+  (void) timer;
+  (void) data;
+  sl_bt_external_signal(PEOPLE_COUNTING_FLOW_EVENT);
+}
+
+/***************************************************************************//**
+ * Callback on end of the count settle time or of the write budget wait.
+ ******************************************************************************/
+static void people_counting_store_callback(
+    sl_sleeptimer_timer_handle_t *timer, void *data)
+{
+  (void) timer;
+  (void) data;
+  sl_bt_external_signal(PEOPLE_COUNTING_STORE_EVENT);
+}
 
 /***************************************************************************//**
  * Callback on timer period.
@@ -89,6 +89,9 @@ const uint8_t cmd_buff[] = {
 
       SSD1306_DEACTIVATE_SCROLL, /* Stop scroll */
 
+      SSD1306_MEMORYMODE, /* 0x20 Set Memory Addressing Mode */
+      0x00, /* Horizontal, the data wraps to the next page of the window */
+
       SSD1306_DISPLAYON    /*  0xAF Set OLED Display On */
 };
 
@@ -129,26 +132,73 @@ sl_status_t ssd1306_init(void)
  *   SL_STATUS_OK if there are no errors.
  *****************************************************************************/
 sl_status_t ssd1306_draw(const void *data)
+{
+  return ssd1306_draw_region(data,
+                             0, (SSD1306_DISPLAY_HEIGHT / 8) - 1,
+                             0, SSD1306_DISPLAY_WIDTH - 1);
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Draw a region of pages and columns to SSD1306.
+ *
+ * @param[in] data
+ *   Pointer to the pixel matrix buffer of the whole display, only the region
+ *   is sent.
+ *
+ * @param[in] first_page
+ *   First page of the region
+ *
+ * @param[in] last_page
+ *   Last page of the region
+ *
+ * @param[in] first_column
+ *   First column of the region
+ *
+ * @param[in] last_column
+ *   Last column of the region
+ *
+ * @return
+ *   SL_STATUS_OK if there are no errors.
+ *****************************************************************************/
+sl_status_t ssd1306_draw_region(const void *data,
+                                uint8_t first_page, uint8_t last_page,
+                                uint8_t first_column, uint8_t last_column)
 {
   sl_status_t sc = SL_STATUS_OK;
   unsigned int i;
   const uint8_t *ptr = data;
-  uint8_t cmd;
-  uint8_t no_pages = SSD1306_DISPLAY_HEIGHT / 8;
-
-  /* Get start address to draw from */
-  for ( i = 0; i < no_pages; i++ ) {
-  /* Send update command and first line address */
-    cmd = 0xB0 + i;  /* Set the current RAM page address. */
-    sc += ssd1306_send_command(&cmd, 1);
-    cmd = 0x00;  /* Set Lower Column Start Address for Page Addressing Mode */
-    sc += ssd1306_send_command(&cmd, 1);
-    cmd = 0x12;  /* Set Higher Column Start Address for Page Addressing Mode */
-    sc += ssd1306_send_command(&cmd, 1);
-
-  /* Send pixels for this page */
-    sc += ssd1306_send_data(ptr, SSD1306_DISPLAY_WIDTH);
-    ptr += SSD1306_DISPLAY_WIDTH;
+  uint8_t cmd_buff[6] = {
+      SSD1306_COLUMNADDR,   /* 0x21 Set Column Address */
+      SSD1306_DISPLAY_COLUMN_OFFSET + first_column,
+      SSD1306_DISPLAY_COLUMN_OFFSET + last_column,
+      SSD1306_PAGEADDR,     /* 0x22 Set Page Address */
+      first_page,
+      last_page
+  };
+
+  if ((first_page > last_page)
+      || (last_page >= SSD1306_DISPLAY_HEIGHT / 8)
+      || (first_column > last_column)
+      || (last_column >= SSD1306_DISPLAY_WIDTH)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  /* Set the window, the RAM address moves to the next page at its end */
+  sc += ssd1306_send_command(cmd_buff, sizeof(cmd_buff));
+
+  ptr += first_page * SSD1306_DISPLAY_WIDTH + first_column;
+  if ((first_column == 0) && (last_column == SSD1306_DISPLAY_WIDTH - 1)) {
+    /* Full width pages follow each other in the buffer, send them at once */
+    sc += ssd1306_send_data(ptr,
+                            (last_page - first_page + 1) * SSD1306_DISPLAY_WIDTH);
+  }
+  else {
+    /* Send the columns of the region for each page */
+    for (i = first_page; i <= last_page; i++) {
+      sc += ssd1306_send_data(ptr, last_column - first_column + 1);
+      ptr += SSD1306_DISPLAY_WIDTH;
+    }
   }
   if (sc != SL_STATUS_OK) {
     return SL_STATUS_TRANSMIT;
@@ -37,6 +37,12 @@
 #include <ssd1306_i2c.h>
 #include "sl_i2cspm.h"
 #include "sl_i2cspm_qwiic_config.h"
+#include "i2c_bus_arbiter.h"
+
+/* Longest data transfer, about 3 ms at 400 kHz. The display RAM address
+   carries on from one transfer to the next, a pending VL53L1X readout goes
+   in between. */
+#define SSD1306_I2C_MAX_DATA_LEN  128
 
 /***************************************************************************//**
  * @brief
@@ -71,24 +77,20 @@ sl_status_t ssd1306_send_command(const void *cmd, uint8_t len)
 {
   I2C_TransferSeq_TypeDef    seq;
   I2C_TransferReturn_TypeDef ret;
-  uint8_t i2c_write_data[len];
-  uint8_t i2c_read_data[1];
-  const uint8_t *ptr = cmd;
+  uint8_t control = 0x00; // Co = 0, D/C# = 0: all the next bytes are commands
 
   seq.addr  = SSD1306_SLAVE_ADDRESS << 1;
-  seq.flags = I2C_FLAG_WRITE;
-  /* Select register and data to write */
-  i2c_write_data[0] = 0x00; // 0x00 for cmd, 0x40 for data
-  for (int i = 0; i < len; i++) {
-    i2c_write_data[i + 1] = ptr[i];
-  }
-
-  seq.buf[0].data = i2c_write_data;
-  seq.buf[0].len  = len + 1;
-  /* Select location/length of data to be read */
-  seq.buf[1].data = i2c_read_data;
-  seq.buf[1].len  = 0;
+  seq.flags = I2C_FLAG_WRITE_WRITE;
+  /* The control byte, then the commands straight from the caller buffer */
+  seq.buf[0].data = &control;
+  seq.buf[0].len  = 1;
+  seq.buf[1].data = (uint8_t *) cmd;
+  seq.buf[1].len  = len;
+  /* A pending VL53L1X readout goes first, it preempts the display between
+     two transfers */
+  i2c_bus_arbiter_acquire(I2C_BUS_CLIENT_DISPLAY);
   ret = I2CSPM_Transfer(SL_I2CSPM_QWIIC_PERIPHERAL, &seq);
+  i2c_bus_arbiter_release(I2C_BUS_CLIENT_DISPLAY);
   if (ret != i2cTransferDone) {
     return SL_STATUS_TRANSMIT;
   }
@@ -112,31 +114,34 @@ sl_status_t ssd1306_send_command(const void *cmd, uint8_t len)
  * @return
  *    @ref SL_STATUS_OK on success or @ref SL_STATUS_FAIL on failure
  ******************************************************************************/
-sl_status_t ssd1306_send_data(const void *data, uint8_t len)
+sl_status_t ssd1306_send_data(const void *data, uint16_t len)
 {
   I2C_TransferSeq_TypeDef    seq;
   I2C_TransferReturn_TypeDef ret;
-  uint8_t i2c_write_data[len];
-  uint8_t i2c_read_data[1];
+  uint8_t control = 0x40; // Co = 0, D/C# = 1: all the next bytes are data
   const uint8_t *ptr = data;
+  uint16_t chunk;
 
   seq.addr  = SSD1306_SLAVE_ADDRESS << 1;
-  seq.flags = I2C_FLAG_WRITE;
-  /* Select register and data to write */
-  i2c_write_data[0] = 0x40; // 0x00 for cmd, 0x40 for data
-  for (int i = 0; i < len; i++) {
-    i2c_write_data[i+1] = ptr[i];
-  }
-  seq.buf[0].data = i2c_write_data;
-  seq.buf[0].len  = len + 1;
-  /* Select location/length of data to be read */
-  seq.buf[1].data = i2c_read_data;
-  seq.buf[1].len  = 0;
-  ret = I2CSPM_Transfer(SL_I2CSPM_QWIIC_PERIPHERAL, &seq);
-  if (ret != i2cTransferDone) {
-    return SL_STATUS_TRANSMIT;
+  seq.flags = I2C_FLAG_WRITE_WRITE;
+  seq.buf[0].data = &control;
+  seq.buf[0].len  = 1;
+  while (len > 0) {
+    chunk = (len > SSD1306_I2C_MAX_DATA_LEN) ? SSD1306_I2C_MAX_DATA_LEN : len;
+    /* The pixels straight from the caller buffer */
+    seq.buf[1].data = (uint8_t *) ptr;
+    seq.buf[1].len  = chunk;
+    /* A pending VL53L1X readout goes first, it preempts the display between
+       two transfers */
+    i2c_bus_arbiter_acquire(I2C_BUS_CLIENT_DISPLAY);
+    ret = I2CSPM_Transfer(SL_I2CSPM_QWIIC_PERIPHERAL, &seq);
+    i2c_bus_arbiter_release(I2C_BUS_CLIENT_DISPLAY);
+    if (ret != i2cTransferDone) {
+      return SL_STATUS_TRANSMIT;
+    }
+    ptr += chunk;
+    len -= chunk;
   }
 
   return SL_STATUS_OK;
 }
-
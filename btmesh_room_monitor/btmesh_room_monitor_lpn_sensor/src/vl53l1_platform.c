@@ -31,52 +31,124 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *
  */
+#ifndef VL53L1X_PLATFORM_EMULATOR
+
 #include <string.h>
+#include "em_core.h"
+#include "em_emu.h"
+#include "sl_component_catalog.h"
+#if defined(SL_CATALOG_POWER_MANAGER_PRESENT)
+#include "sl_power_manager.h"
+#endif
 #include "vl53l1_platform.h"
 #include "vl53l1x_config.h"
+#include "i2c_bus_arbiter.h"
+
+/* Register index and largest payload of a queued write */
+#define VL53L1_PLATFORM_INDEX_SIZE	2
+#define VL53L1_PLATFORM_WRITE_MAX	4
+
+typedef struct {
+	I2C_TransferSeq_TypeDef seq;
+	uint8_t buffer[VL53L1_PLATFORM_INDEX_SIZE + VL53L1_PLATFORM_WRITE_MAX];
+	vl53l1_platform_callback_t callback;
+	void *context;
+} vl53l1_platform_transfer_t;
+
+typedef struct {
+	volatile bool done;
+	sl_status_t status;
+} vl53l1_platform_sync_t;
 
 static sl_i2cspm_t *_vl53l1x_i2cspm_instance = VL53L1X_CONFIG_I2C_INSTANCE;
 
-static sl_status_t
-i2c_write_blocking(uint8_t addr, uint16_t index, const uint8_t *src, int len);
-static sl_status_t
-i2c_write_read_blocking(uint8_t addr, uint16_t index, uint8_t *data, int len);
+/* Transaction queue, the head entry is on the bus */
+static vl53l1_platform_transfer_t
+		_transfer_queue[VL53L1X_CONFIG_I2C_QUEUE_SIZE];
+static volatile uint8_t _queue_head;
+static volatile uint8_t _queue_count;
+/* Result of a transfer that failed to start, completed by the interrupt */
+static volatile I2C_TransferReturn_TypeDef _start_result = i2cTransferInProgress;
+
+static sl_status_t i2c_submit(uint8_t addr, uint16_t index, uint16_t flags,
+		const uint8_t *src, uint8_t *dst, uint32_t len,
+		vl53l1_platform_callback_t callback, void *context);
+static sl_status_t i2c_submit_blocking(uint8_t addr, uint16_t index,
+		uint16_t flags, const uint8_t *src, uint8_t *dst, uint32_t len);
+static void i2c_start_transfer(vl53l1_platform_transfer_t *transfer);
+static void i2c_bus_granted(void);
+static void i2c_sync_done(sl_status_t status, void *context);
 
 void vl53l1x_platform_set_i2cspm_instance(sl_i2cspm_t *i2cspm_instance) {
 	_vl53l1x_i2cspm_instance = i2cspm_instance;
 }
 
+sl_status_t vl53l1_platform_read_async(uint16_t dev, uint16_t index,
+		uint8_t *pdata, uint32_t count, vl53l1_platform_callback_t callback,
+		void *context) {
+	return i2c_submit(dev, index, I2C_FLAG_WRITE_READ, NULL, pdata, count,
+			callback, context);
+}
+
+sl_status_t vl53l1_platform_write_async(uint16_t dev, uint16_t index,
+		const uint8_t *pdata, uint32_t count,
+		vl53l1_platform_callback_t callback, void *context) {
+	return i2c_submit(dev, index, I2C_FLAG_WRITE, pdata, NULL, count,
+			callback, context);
+}
+
+bool vl53l1_platform_is_busy(void) {
+	return _queue_count != 0;
+}
+
+void vl53l1_platform_wait_idle(void) {
+	CORE_DECLARE_IRQ_STATE;
+
+	/* PRIMASK only, a pending I2C interrupt masked by BASEPRI would not wake
+	 * up the core */
+	CORE_ENTER_CRITICAL();
+	while (_queue_count != 0) {
+		/* Wakes up on the I2C interrupt, the peripheral runs in EM1 */
+		EMU_EnterEM1();
+		CORE_EXIT_CRITICAL();
+		CORE_ENTER_CRITICAL();
+	}
+	CORE_EXIT_CRITICAL();
+}
+
 sl_status_t VL53L1_ReadMulti(uint16_t dev, uint16_t index, uint8_t *pdata,
 		uint32_t count) {
-	return i2c_write_read_blocking(dev, index, pdata, count);
+	return i2c_submit_blocking(dev, index, I2C_FLAG_WRITE_READ, NULL, pdata,
+			count);
 }
 
 sl_status_t VL53L1_WrByte(uint16_t dev, uint16_t index, uint8_t data) {
-	return i2c_write_blocking(dev, index, &data, 1);
+	return i2c_submit_blocking(dev, index, I2C_FLAG_WRITE, &data, NULL, 1);
 }
 
 sl_status_t VL53L1_WrWord(uint16_t dev, uint16_t index, uint16_t data) {
 	uint8_t dataBytes[2] = { data >> 8, data & 0x00FF, };
 
-	return i2c_write_blocking(dev, index, dataBytes, 2);
+	return i2c_submit_blocking(dev, index, I2C_FLAG_WRITE, dataBytes, NULL, 2);
 }
 
 sl_status_t VL53L1_WrDWord(uint16_t dev, uint16_t index, uint32_t data) {
 	uint8_t dataBytes[4] = { (data >> 24) & 0xFF, (data >> 16) & 0xFF, (data
 			>> 8) & 0xFF, (data >> 0) & 0xFF };
 
-	return i2c_write_blocking(dev, index, dataBytes, 4);
+	return i2c_submit_blocking(dev, index, I2C_FLAG_WRITE, dataBytes, NULL, 4);
 }
 
 sl_status_t VL53L1_RdByte(uint16_t dev, uint16_t index, uint8_t *data) {
-	return i2c_write_read_blocking(dev, index, data, 1);
+	return i2c_submit_blocking(dev, index, I2C_FLAG_WRITE_READ, NULL, data, 1);
 }
 
 sl_status_t VL53L1_RdWord(uint16_t dev, uint16_t index, uint16_t *data) {
 	uint8_t receivedData[2];
 	sl_status_t status = SL_STATUS_OK;
 
-	status = i2c_write_read_blocking(dev, index, receivedData, 2);
+	status = i2c_submit_blocking(dev, index, I2C_FLAG_WRITE_READ, NULL,
+			receivedData, 2);
 	*data = ((uint16_t) receivedData[0] << 8) + (uint16_t) receivedData[1];
 
 	return status;
@@ -86,7 +158,8 @@ sl_status_t VL53L1_RdDWord(uint16_t dev, uint16_t index, uint32_t *data) {
 	uint8_t receivedData[4];
 	sl_status_t status = SL_STATUS_OK;
 
-	status = i2c_write_read_blocking(dev, index, receivedData, 4);
+	status = i2c_submit_blocking(dev, index, I2C_FLAG_WRITE_READ, NULL,
+			receivedData, 4);
 
 	*data = ((uint32_t) receivedData[0] << 24)
 			+ ((uint32_t) receivedData[1] << 16)
@@ -97,51 +170,150 @@ sl_status_t VL53L1_RdDWord(uint16_t dev, uint16_t index, uint32_t *data) {
 
 // Silicon Labs I2C platform component integration
 
-static sl_status_t i2c_write_blocking(uint8_t addr, uint16_t index,
-		const uint8_t *src, int len) {
+static sl_status_t i2c_submit(uint8_t addr, uint16_t index, uint16_t flags,
+		const uint8_t *src, uint8_t *dst, uint32_t len,
+		vl53l1_platform_callback_t callback, void *context) {
+	vl53l1_platform_transfer_t *transfer;
+	CORE_DECLARE_IRQ_STATE;
 
-	I2C_TransferSeq_TypeDef seq;
-	uint8_t i2c_write_data[len + 2];
+	if (((I2C_FLAG_WRITE == flags) && (len > VL53L1_PLATFORM_WRITE_MAX))
+			|| ((I2C_FLAG_WRITE_READ == flags) && (len > UINT16_MAX))) {
+		return SL_STATUS_INVALID_PARAMETER;
+	}
 
-	seq.addr = addr << 1;
-	seq.flags = I2C_FLAG_WRITE;
+	CORE_ENTER_ATOMIC();
+	if (_queue_count >= VL53L1X_CONFIG_I2C_QUEUE_SIZE) {
+		CORE_EXIT_ATOMIC();
+		return SL_STATUS_NO_MORE_RESOURCE;
+	}
+	transfer = &_transfer_queue[(_queue_head + _queue_count)
+			% VL53L1X_CONFIG_I2C_QUEUE_SIZE];
 
-	i2c_write_data[0] = index >> 8;
-	i2c_write_data[1] = index & 0xFF;
+	transfer->seq.addr = addr << 1;
+	transfer->seq.flags = flags;
+	transfer->buffer[0] = index >> 8;
+	transfer->buffer[1] = index & 0xFF;
+	transfer->seq.buf[0].data = transfer->buffer;
+	transfer->seq.buf[0].len = VL53L1_PLATFORM_INDEX_SIZE;
+	if (I2C_FLAG_WRITE == flags) {
+		/* The payload is copied, the caller buffer may go out of scope */
+		memcpy(&transfer->buffer[VL53L1_PLATFORM_INDEX_SIZE], src, len);
+		transfer->seq.buf[0].len += len;
+	} else {
+		/* Read data lands directly in the caller buffer */
+		transfer->seq.buf[1].data = dst;
+		transfer->seq.buf[1].len = len;
+	}
+	transfer->callback = callback;
+	transfer->context = context;
 
-	memcpy(&i2c_write_data[2], src, len);
+	if (0 == _queue_count++) {
+#if defined(SL_CATALOG_POWER_MANAGER_PRESENT)
+		sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
+#endif
+		/* Started on release of the bus if a display transfer is ongoing */
+		if (i2c_bus_arbiter_request(I2C_BUS_CLIENT_SENSOR, i2c_bus_granted)) {
+			i2c_start_transfer(transfer);
+		}
+	}
+	CORE_EXIT_ATOMIC();
 
-	/*Write buffer*/
-	seq.buf[0].data = i2c_write_data;
-	seq.buf[0].len = len + 2;
+	return SL_STATUS_OK;
+}
+
+static sl_status_t i2c_submit_blocking(uint8_t addr, uint16_t index,
+		uint16_t flags, const uint8_t *src, uint8_t *dst, uint32_t len) {
+	vl53l1_platform_sync_t sync = { .done = false, .status = SL_STATUS_OK };
+	sl_status_t status;
+	CORE_DECLARE_IRQ_STATE;
 
-	if (I2CSPM_Transfer(_vl53l1x_i2cspm_instance, &seq) != i2cTransferDone) {
-		return SL_STATUS_TRANSMIT;
+	do {
+		status = i2c_submit(addr, index, flags, src, dst, len, i2c_sync_done,
+				&sync);
+		if (SL_STATUS_NO_MORE_RESOURCE == status) {
+			/* Queue is full, let the pending transfers drain */
+			vl53l1_platform_wait_idle();
+		}
+	} while (SL_STATUS_NO_MORE_RESOURCE == status);
+	if (SL_STATUS_OK != status) {
+		return status;
 	}
-	return SL_STATUS_OK;
+
+	/* Same wait as vl53l1_platform_wait_idle(), the I2C interrupt must wake
+	 * up the core */
+	CORE_ENTER_CRITICAL();
+	while (!sync.done) {
+		EMU_EnterEM1();
+		CORE_EXIT_CRITICAL();
+		CORE_ENTER_CRITICAL();
+	}
+	CORE_EXIT_CRITICAL();
+
+	return sync.status;
 }
 
-static sl_status_t i2c_write_read_blocking(uint8_t addr, uint16_t index,
-		uint8_t *data, int len) {
-	I2C_TransferSeq_TypeDef seq;
-	uint8_t i2c_write_data[len];
+static void i2c_sync_done(sl_status_t status, void *context) {
+	vl53l1_platform_sync_t *sync = (vl53l1_platform_sync_t *) context;
 
-	seq.addr = addr << 1;
-	seq.flags = I2C_FLAG_WRITE_READ;
+	sync->status = status;
+	sync->done = true;
+}
 
-	i2c_write_data[0] = index >> 8;
-	i2c_write_data[1] = index & 0xFF;
+static void i2c_start_transfer(vl53l1_platform_transfer_t *transfer) {
+	I2C_TransferReturn_TypeDef ret;
 
-	/*Write buffer*/
-	seq.buf[0].data = i2c_write_data;
-	seq.buf[0].len = 2;
+	NVIC_ClearPendingIRQ(VL53L1X_CONFIG_I2C_IRQ);
+	NVIC_EnableIRQ(VL53L1X_CONFIG_I2C_IRQ);
+	/* The first bytes are sent here, the rest is driven by the interrupt */
+	ret = I2C_TransferInit(_vl53l1x_i2cspm_instance, &transfer->seq);
+	if (i2cTransferInProgress != ret) {
+		_start_result = ret;
+		NVIC_SetPendingIRQ(VL53L1X_CONFIG_I2C_IRQ);
+	}
+}
 
-	/*Read buffer*/
-	seq.buf[1].data = data;
-	seq.buf[1].len = len;
+static void i2c_bus_granted(void) {
+	i2c_start_transfer(&_transfer_queue[_queue_head]);
+}
 
-	if (I2CSPM_Transfer(_vl53l1x_i2cspm_instance, &seq) != i2cTransferDone) {
-		return SL_STATUS_TRANSMIT;
+void VL53L1X_CONFIG_I2C_IRQ_HANDLER(void) {
+	I2C_TransferReturn_TypeDef ret;
+	vl53l1_platform_callback_t callback;
+	void *context;
+
+	if (i2cTransferInProgress != _start_result) {
+		ret = _start_result;
+		_start_result = i2cTransferInProgress;
+	} else {
+		ret = I2C_Transfer(_vl53l1x_i2cspm_instance);
+	}
+	if ((i2cTransferInProgress == ret) || (0 == _queue_count)) {
+		return;
+	}
+
+	callback = _transfer_queue[_queue_head].callback;
+	context = _transfer_queue[_queue_head].context;
+	_queue_head = (_queue_head + 1) % VL53L1X_CONFIG_I2C_QUEUE_SIZE;
+	_queue_count--;
+
+	if (_queue_count != 0) {
+		i2c_start_transfer(&_transfer_queue[_queue_head]);
+	} else {
+		/* Leave the peripheral to the blocking I2CSPM users */
+		NVIC_DisableIRQ(VL53L1X_CONFIG_I2C_IRQ);
+#if defined(SL_CATALOG_POWER_MANAGER_PRESENT)
+		sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
+#endif
+	}
+
+	if (NULL != callback) {
+		callback((i2cTransferDone == ret) ? SL_STATUS_OK : SL_STATUS_TRANSMIT,
+				context);
+	}
+	/* Keep the bus over a transfer chained by the callback */
+	if (0 == _queue_count) {
+		i2c_bus_arbiter_release(I2C_BUS_CLIENT_SENSOR);
 	}
-	return SL_STATUS_OK;
 }
+
+#endif /* VL53L1X_PLATFORM_EMULATOR */
@@ -0,0 +1,620 @@
+/***************************************************************************//**
+ * @file vl53l1_platform_emul.c
+ * @brief VL53L1X register level emulator for host builds
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with the
+ * specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#ifdef VL53L1X_PLATFORM_EMULATOR
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vl53l1x_core.h"
+#include "vl53l1_platform.h"
+#include "vl53l1_platform_emul.h"
+
+#define VL53L1_EMUL_DEFAULT_ADDR	0x29
+#define VL53L1_EMUL_REG_COUNT		0x0200
+#define VL53L1_EMUL_INDEX_SIZE		2
+#define VL53L1_EMUL_MODEL_ID		0xEACC
+#define VL53L1_EMUL_OSC_CALIBRATE	0x0150
+#define VL53L1_EMUL_BOOT_TIME_US	1200
+#define VL53L1_EMUL_MODE_RANGING	0x40
+#define VL53L1_EMUL_FW_BOOTED		0x03
+/* SYSTEM__INTERRUPT_CONFIG_GPIO: every ranging, else the window mode */
+#define VL53L1_EMUL_NEW_SAMPLE_READY	0x20
+#define VL53L1_EMUL_WINDOW_MASK		0x03
+/* Polarity bit of GPIO_HV_MUX__CTRL, set for active low */
+#define VL53L1_EMUL_ACTIVE_LOW		0x10
+/* Data and ACK bits per byte, START and STOP conditions per frame */
+#define VL53L1_EMUL_BYTE_BITS		9
+#define VL53L1_EMUL_FRAME_BITS		2
+#define VL53L1_EMUL_LINE_MAX		128
+
+typedef struct {
+	bool powered;
+	uint8_t regs[VL53L1_EMUL_REG_COUNT];
+	uint64_t boot_ns;
+	bool ranging;
+	/* A result is latched and the interrupt is not cleared */
+	bool interrupt;
+	uint64_t next_ranging_ns;
+	/* ROI center sampled at the start of the ongoing ranging */
+	uint8_t ranging_roi;
+	const vl53l1_emul_sample_t *trace;
+	size_t trace_count;
+	size_t trace_cursor;
+	uint64_t trace_start_ns;
+	/* Trace allocated by vl53l1_emul_load_trace() */
+	vl53l1_emul_sample_t *trace_owned;
+} vl53l1_emul_device_t;
+
+/* Raw range status of each VL53L1X_GetRangeStatus() value */
+static const uint8_t _raw_status[] = { 9, 6, 4, 8, 5, 3, 19, 7, 0, 12, 18,
+		22, 23, 13 };
+
+/* Returned when the trace has no sample for the ROI yet */
+static const vl53l1_emul_sample_t _no_target = { .time_ms = 0, .roi_center =
+		VL53L1_EMUL_ROI_ANY, .status = 2, .distance = 0, .signal_per_spad = 0,
+		.ambient_per_spad = 0, .spads = 0 };
+
+static vl53l1_emul_device_t _devices[VL53L1_EMUL_MAX_DEVICES];
+static uint64_t _now_ns;
+static uint64_t _bus_time_ns;
+static uint32_t _bus_frequency = 400000;
+static vl53l1_emul_stats_t _stats;
+
+static sl_status_t emul_transfer(uint16_t dev, uint16_t index, bool read,
+		uint8_t *data, uint32_t len);
+static void emul_bus_time(uint32_t bits);
+static void emul_advance_ns(uint64_t time_ns);
+static vl53l1_emul_device_t *emul_find_device(uint16_t dev);
+static void emul_reset(vl53l1_emul_device_t *device);
+static void emul_update(vl53l1_emul_device_t *device);
+static void emul_write(vl53l1_emul_device_t *device, uint16_t index,
+		const uint8_t *data, uint32_t len);
+static void emul_complete_ranging(vl53l1_emul_device_t *device,
+		uint64_t time_ns);
+static const vl53l1_emul_sample_t *emul_find_sample(
+		vl53l1_emul_device_t *device, uint32_t time_ms, uint8_t roi);
+static uint64_t emul_period_ns(const vl53l1_emul_device_t *device);
+static bool emul_in_window(const vl53l1_emul_device_t *device,
+		uint16_t distance);
+static uint16_t emul_get_word(const vl53l1_emul_device_t *device,
+		uint16_t index);
+
+// Emulator control
+
+void vl53l1_emul_init(uint32_t bus_frequency) {
+	uint8_t i;
+
+	for (i = 0; i < VL53L1_EMUL_MAX_DEVICES; i++) {
+		free(_devices[i].trace_owned);
+	}
+	memset(_devices, 0, sizeof(_devices));
+	memset(&_stats, 0, sizeof(_stats));
+	_now_ns = 0;
+	_bus_time_ns = 0;
+	_bus_frequency = bus_frequency;
+
+	emul_reset(&_devices[0]);
+	_devices[0].powered = true;
+}
+
+sl_status_t vl53l1_emul_set_xshut(uint8_t index, bool enable) {
+	vl53l1_emul_device_t *device;
+
+	if (index >= VL53L1_EMUL_MAX_DEVICES) {
+		return SL_STATUS_INVALID_PARAMETER;
+	}
+	device = &_devices[index];
+	if (enable && !device->powered) {
+		emul_reset(device);
+	}
+	device->powered = enable;
+
+	return SL_STATUS_OK;
+}
+
+sl_status_t vl53l1_emul_set_trace(uint8_t index,
+		const vl53l1_emul_sample_t *samples, size_t count) {
+	vl53l1_emul_device_t *device;
+
+	if (index >= VL53L1_EMUL_MAX_DEVICES) {
+		return SL_STATUS_INVALID_PARAMETER;
+	}
+	device = &_devices[index];
+	if (samples != device->trace_owned) {
+		free(device->trace_owned);
+		device->trace_owned = NULL;
+	}
+	device->trace = samples;
+	device->trace_count = count;
+	device->trace_cursor = 0;
+	device->trace_start_ns = _now_ns;
+
+	return SL_STATUS_OK;
+}
+
+sl_status_t vl53l1_emul_load_trace(uint8_t index, const char *path) {
+	char line[VL53L1_EMUL_LINE_MAX];
+	vl53l1_emul_sample_t *samples = NULL;
+	vl53l1_emul_sample_t *grown;
+	size_t count = 0;
+	size_t capacity = 0;
+	unsigned int roi, status, distance, signal, ambient, spads;
+	unsigned long time_ms;
+	FILE *file;
+
+	if (index >= VL53L1_EMUL_MAX_DEVICES) {
+		return SL_STATUS_INVALID_PARAMETER;
+	}
+	file = fopen(path, "r");
+	if (NULL == file) {
+		return SL_STATUS_NOT_FOUND;
+	}
+	while (NULL != fgets(line, sizeof(line), file)) {
+		if (7 != sscanf(line, "%lu,%u,%u,%u,%u,%u,%u", &time_ms, &roi,
+				&status, &distance, &signal, &ambient, &spads)) {
+			/* Comment or empty line */
+			continue;
+		}
+		if (count == capacity) {
+			capacity = capacity ? capacity * 2 : 256;
+			grown = realloc(samples, capacity * sizeof(*samples));
+			if (NULL == grown) {
+				free(samples);
+				fclose(file);
+				return SL_STATUS_ALLOCATION_FAILED;
+			}
+			samples = grown;
+		}
+		samples[count].time_ms = time_ms;
+		samples[count].roi_center = roi;
+		samples[count].status = status;
+		samples[count].distance = distance;
+		samples[count].signal_per_spad = signal;
+		samples[count].ambient_per_spad = ambient;
+		samples[count].spads = spads;
+		count++;
+	}
+	fclose(file);
+
+	vl53l1_emul_set_trace(index, samples, count);
+	_devices[index].trace_owned = samples;
+
+	return SL_STATUS_OK;
+}
+
+void vl53l1_emul_advance_us(uint32_t time_us) {
+	emul_advance_ns((uint64_t) time_us * 1000);
+}
+
+uint64_t vl53l1_emul_get_time_us(void) {
+	return _now_ns / 1000;
+}
+
+sl_status_t vl53l1_emul_get_next_ranging_time_us(uint8_t index,
+		uint64_t *time_us) {
+	if (index >= VL53L1_EMUL_MAX_DEVICES) {
+		return SL_STATUS_INVALID_PARAMETER;
+	}
+	if (_devices[index].powered && _devices[index].ranging) {
+		*time_us = (_devices[index].next_ranging_ns + 999) / 1000;
+	} else {
+		*time_us = UINT64_MAX;
+	}
+
+	return SL_STATUS_OK;
+}
+
+bool vl53l1_emul_get_gpio1(uint8_t index) {
+	if (index >= VL53L1_EMUL_MAX_DEVICES) {
+		return false;
+	}
+	emul_update(&_devices[index]);
+
+	return _devices[index].regs[GPIO__TIO_HV_STATUS] & 0x01;
+}
+
+void vl53l1_emul_get_stats(vl53l1_emul_stats_t *stats) {
+	*stats = _stats;
+	stats->bus_time_us = _bus_time_ns / 1000;
+}
+
+void vl53l1_emul_reset_stats(void) {
+	memset(&_stats, 0, sizeof(_stats));
+	_bus_time_ns = 0;
+}
+
+// Platform functions
+
+bool vl53l1_platform_is_busy(void) {
+	/* Transfers complete on submission */
+	return false;
+}
+
+void vl53l1_platform_wait_idle(void) {
+}
+
+sl_status_t vl53l1_platform_read_async(uint16_t dev, uint16_t index,
+		uint8_t *pdata, uint32_t count, vl53l1_platform_callback_t callback,
+		void *context) {
+	sl_status_t status = emul_transfer(dev, index, true, pdata, count);
+
+	if (NULL != callback) {
+		callback(status, context);
+	}
+	return SL_STATUS_OK;
+}
+
+sl_status_t vl53l1_platform_write_async(uint16_t dev, uint16_t index,
+		const uint8_t *pdata, uint32_t count,
+		vl53l1_platform_callback_t callback, void *context) {
+	sl_status_t status = emul_transfer(dev, index, false, (uint8_t *) pdata,
+			count);
+
+	if (NULL != callback) {
+		callback(status, context);
+	}
+	return SL_STATUS_OK;
+}
+
+sl_status_t VL53L1_ReadMulti(uint16_t dev, uint16_t index, uint8_t *pdata,
+		uint32_t count) {
+	return emul_transfer(dev, index, true, pdata, count);
+}
+
+sl_status_t VL53L1_WrByte(uint16_t dev, uint16_t index, uint8_t data) {
+	return emul_transfer(dev, index, false, &data, 1);
+}
+
+sl_status_t VL53L1_WrWord(uint16_t dev, uint16_t index, uint16_t data) {
+	uint8_t dataBytes[2] = { data >> 8, data & 0x00FF, };
+
+	return emul_transfer(dev, index, false, dataBytes, 2);
+}
+
+sl_status_t VL53L1_WrDWord(uint16_t dev, uint16_t index, uint32_t data) {
+	uint8_t dataBytes[4] = { (data >> 24) & 0xFF, (data >> 16) & 0xFF, (data
+			>> 8) & 0xFF, (data >> 0) & 0xFF };
+
+	return emul_transfer(dev, index, false, dataBytes, 4);
+}
+
+sl_status_t VL53L1_RdByte(uint16_t dev, uint16_t index, uint8_t *data) {
+	return emul_transfer(dev, index, true, data, 1);
+}
+
+sl_status_t VL53L1_RdWord(uint16_t dev, uint16_t index, uint16_t *data) {
+	uint8_t receivedData[2];
+	sl_status_t status;
+
+	status = emul_transfer(dev, index, true, receivedData, 2);
+	*data = ((uint16_t) receivedData[0] << 8) + (uint16_t) receivedData[1];
+
+	return status;
+}
+
+sl_status_t VL53L1_RdDWord(uint16_t dev, uint16_t index, uint32_t *data) {
+	uint8_t receivedData[4];
+	sl_status_t status;
+
+	status = emul_transfer(dev, index, true, receivedData, 4);
+	*data = ((uint32_t) receivedData[0] << 24)
+			+ ((uint32_t) receivedData[1] << 16)
+			+ ((uint32_t) receivedData[2] << 8) + (uint32_t) receivedData[3];
+
+	return status;
+}
+
+// Emulated bus and sensor
+
+static sl_status_t emul_transfer(uint16_t dev, uint16_t index, bool read,
+		uint8_t *data, uint32_t len) {
+	vl53l1_emul_device_t *device = emul_find_device(dev);
+	uint32_t bytes;
+
+	_stats.transfers++;
+	if ((NULL == device) || (index + len > VL53L1_EMUL_REG_COUNT)) {
+		/* Address or register index NACKed */
+		_stats.bytes += 1;
+		emul_bus_time(VL53L1_EMUL_BYTE_BITS + VL53L1_EMUL_FRAME_BITS);
+		if (read) {
+			memset(data, 0, len);
+		}
+		return SL_STATUS_TRANSMIT;
+	}
+
+	/* Address and index, then the data after a repeated start for reads */
+	bytes = 1 + VL53L1_EMUL_INDEX_SIZE + len + (read ? 1 : 0);
+	_stats.bytes += bytes;
+	emul_bus_time(bytes * VL53L1_EMUL_BYTE_BITS
+			+ (read ? 2 : 1) * VL53L1_EMUL_FRAME_BITS);
+
+	/* The registers are accessed at the end of the transfer */
+	emul_update(device);
+	if (read) {
+		memcpy(data, &device->regs[index], len);
+	} else {
+		emul_write(device, index, data, len);
+	}
+
+	return SL_STATUS_OK;
+}
+
+static void emul_bus_time(uint32_t bits) {
+	uint64_t time_ns = (uint64_t) bits * 1000000000 / _bus_frequency;
+
+	_bus_time_ns += time_ns;
+	emul_advance_ns(time_ns);
+}
+
+static void emul_advance_ns(uint64_t time_ns) {
+	uint8_t i;
+
+	_now_ns += time_ns;
+	for (i = 0; i < VL53L1_EMUL_MAX_DEVICES; i++) {
+		emul_update(&_devices[i]);
+	}
+}
+
+static vl53l1_emul_device_t *emul_find_device(uint16_t dev) {
+	uint8_t i;
+
+	for (i = 0; i < VL53L1_EMUL_MAX_DEVICES; i++) {
+		if (_devices[i].powered
+				&& ((_devices[i].regs[VL53L1_I2C_SLAVE__DEVICE_ADDRESS] & 0x7F)
+						== dev)) {
+			return &_devices[i];
+		}
+	}
+	return NULL;
+}
+
+static void emul_reset(vl53l1_emul_device_t *device) {
+	memset(device->regs, 0, sizeof(device->regs));
+	device->regs[VL53L1_I2C_SLAVE__DEVICE_ADDRESS] = VL53L1_EMUL_DEFAULT_ADDR;
+	device->regs[VL53L1_IDENTIFICATION__MODEL_ID] = VL53L1_EMUL_MODEL_ID >> 8;
+	device->regs[VL53L1_IDENTIFICATION__MODEL_ID + 1] = VL53L1_EMUL_MODEL_ID
+			& 0xFF;
+	device->regs[VL53L1_RESULT__OSC_CALIBRATE_VAL] = VL53L1_EMUL_OSC_CALIBRATE
+			>> 8;
+	device->regs[VL53L1_RESULT__OSC_CALIBRATE_VAL + 1] =
+			VL53L1_EMUL_OSC_CALIBRATE & 0xFF;
+	device->boot_ns = _now_ns + (uint64_t) VL53L1_EMUL_BOOT_TIME_US * 1000;
+	device->ranging = false;
+	device->interrupt = false;
+}
+
+static void emul_update(vl53l1_emul_device_t *device) {
+	uint8_t polarity;
+
+	if (!device->powered) {
+		return;
+	}
+	device->regs[VL53L1_FIRMWARE__SYSTEM_STATUS] =
+			(_now_ns >= device->boot_ns) ? VL53L1_EMUL_FW_BOOTED : 0x00;
+
+	while (device->ranging && (device->next_ranging_ns <= _now_ns)) {
+		emul_complete_ranging(device, device->next_ranging_ns);
+		/* The next ranging starts right away with the current ROI */
+		device->ranging_roi = device->regs[ROI_CONFIG__USER_ROI_CENTRE_SPAD];
+		device->next_ranging_ns += emul_period_ns(device);
+	}
+
+	/* Bit 0 follows the GPIO1 level */
+	polarity = !(device->regs[GPIO_HV_MUX__CTRL] & VL53L1_EMUL_ACTIVE_LOW);
+	device->regs[GPIO__TIO_HV_STATUS] = device->interrupt ?
+			polarity : !polarity;
+}
+
+static void emul_write(vl53l1_emul_device_t *device, uint16_t index,
+		const uint8_t *data, uint32_t len) {
+	uint32_t i;
+	uint16_t reg;
+
+	for (i = 0; i < len; i++) {
+		reg = index + i;
+		device->regs[reg] = data[i];
+		switch (reg) {
+		case SOFT_RESET:
+			if (data[i] & 0x01) {
+				/* End of the reset, the sensor boots again */
+				emul_reset(device);
+			} else {
+				device->ranging = false;
+				device->interrupt = false;
+			}
+			break;
+		case SYSTEM__INTERRUPT_CLEAR:
+			if (data[i] & 0x01) {
+				device->interrupt = false;
+			}
+			device->regs[reg] = 0;
+			break;
+		case SYSTEM__MODE_START:
+			if (VL53L1_EMUL_MODE_RANGING == data[i]) {
+				if (!device->ranging) {
+					device->ranging = true;
+					device->ranging_roi =
+							device->regs[ROI_CONFIG__USER_ROI_CENTRE_SPAD];
+					device->next_ranging_ns = _now_ns + emul_period_ns(device);
+				}
+			} else {
+				device->ranging = false;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+	emul_update(device);
+}
+
+static void emul_complete_ranging(vl53l1_emul_device_t *device,
+		uint64_t time_ns) {
+	const vl53l1_emul_sample_t *sample;
+	uint8_t *result = &device->regs[VL53L1_RESULT__RANGE_STATUS];
+	uint16_t ambient, signal;
+
+	_stats.rangings++;
+	if (device->interrupt) {
+		/* The previous result was not read in time */
+		_stats.overruns++;
+		return;
+	}
+
+	sample = emul_find_sample(device,
+			(uint32_t) ((time_ns - device->trace_start_ns) / 1000000),
+			device->ranging_roi);
+	/* The result block holds the rates of all the SPADs */
+	ambient = (uint16_t) (((uint32_t) sample->ambient_per_spad * sample->spads
+			/ 8) & 0xFFFF);
+	signal = (uint16_t) (((uint32_t) sample->signal_per_spad * sample->spads
+			/ 8) & 0xFFFF);
+
+	memset(result, 0, VL53L1_RESULT__BLOCK_SIZE);
+	result[0] = (sample->status < sizeof(_raw_status)) ?
+			_raw_status[sample->status] : 0;
+	result[3] = sample->spads;
+	result[7] = ambient >> 8;
+	result[8] = ambient & 0xFF;
+	result[13] = sample->distance >> 8;
+	result[14] = sample->distance & 0xFF;
+	result[15] = signal >> 8;
+	result[16] = signal & 0xFF;
+	/* In threshold mode only the valid rangings in the window are
+	 * signaled */
+	if (!(device->regs[SYSTEM__INTERRUPT_CONFIG_GPIO]
+			& VL53L1_EMUL_NEW_SAMPLE_READY)
+			&& ((0 != sample->status)
+					|| !emul_in_window(device, sample->distance))) {
+		return;
+	}
+	device->interrupt = true;
+}
+
+static const vl53l1_emul_sample_t *emul_find_sample(
+		vl53l1_emul_device_t *device, uint32_t time_ms, uint8_t roi) {
+	size_t i;
+
+	if (0 == device->trace_count) {
+		return &_no_target;
+	}
+	while ((device->trace_cursor + 1 < device->trace_count)
+			&& (device->trace[device->trace_cursor + 1].time_ms <= time_ms)) {
+		device->trace_cursor++;
+	}
+	/* Latest sample recorded for this ROI */
+	for (i = device->trace_cursor + 1; i-- > 0;) {
+		if ((device->trace[i].time_ms <= time_ms)
+				&& ((device->trace[i].roi_center == roi)
+						|| (device->trace[i].roi_center == VL53L1_EMUL_ROI_ANY))) {
+			return &device->trace[i];
+		}
+	}
+	return &_no_target;
+}
+
+static uint64_t emul_period_ns(const vl53l1_emul_device_t *device) {
+	uint32_t budget_ms;
+	uint32_t inter_ms;
+	uint16_t clock_pll;
+
+	/* Same encodings as VL53L1X_GetTimingBudgetInMs() */
+	switch (emul_get_word(device, RANGE_CONFIG__TIMEOUT_MACROP_A_HI)) {
+	case 0x001D:
+		budget_ms = 15;
+		break;
+	case 0x0051:
+	case 0x001E:
+		budget_ms = 20;
+		break;
+	case 0x00D6:
+	case 0x0060:
+		budget_ms = 33;
+		break;
+	case 0x01AE:
+	case 0x00AD:
+		budget_ms = 50;
+		break;
+	case 0x03E1:
+	case 0x02D9:
+		budget_ms = 200;
+		break;
+	case 0x0591:
+	case 0x048F:
+		budget_ms = 500;
+		break;
+	default:
+		budget_ms = 100;
+		break;
+	}
+
+	clock_pll = emul_get_word(device, VL53L1_RESULT__OSC_CALIBRATE_VAL) & 0x3FF;
+	inter_ms = ((uint32_t) emul_get_word(device,
+			VL53L1_SYSTEM__INTERMEASUREMENT_PERIOD) << 16)
+			| emul_get_word(device, VL53L1_SYSTEM__INTERMEASUREMENT_PERIOD + 2);
+	inter_ms = clock_pll ? (uint32_t) (inter_ms / (clock_pll * 1.075)) : 0;
+
+	return (uint64_t) ((inter_ms > budget_ms) ? inter_ms : budget_ms) * 1000000;
+}
+
+static bool emul_in_window(const vl53l1_emul_device_t *device,
+		uint16_t distance) {
+	uint16_t low = emul_get_word(device, SYSTEM__THRESH_LOW);
+	uint16_t high = emul_get_word(device, SYSTEM__THRESH_HIGH);
+
+	/* Same encodings as VL53L1X_SetDistanceThreshold() */
+	switch (device->regs[SYSTEM__INTERRUPT_CONFIG_GPIO]
+			& VL53L1_EMUL_WINDOW_MASK) {
+	case 0:
+		return distance < low;
+	case 1:
+		return distance > high;
+	case 2:
+		return (distance < low) || (distance > high);
+	default:
+		return (distance >= low) && (distance <= high);
+	}
+}
+
+static uint16_t emul_get_word(const vl53l1_emul_device_t *device,
+		uint16_t index) {
+	return ((uint16_t) device->regs[index] << 8) | device->regs[index + 1];
+}
+
+#endif /* VL53L1X_PLATFORM_EMULATOR */
@@ -37,6 +37,7 @@
  ******************************************************************************/
 
 #include <stddef.h>
+#include <stdbool.h>
 #include "vl53l1x_core.h"
 #include "vl53l1x_calibration.h"
 #include "vl53l1x_config.h"
@@ -48,10 +49,64 @@
 extern "C" {
 #endif
 
+/* SYSTEM__INTERRUPT_CONFIG_GPIO: interrupt on every ranging */
+#define VL53L1X_INTERRUPT_NEW_SAMPLE_READY	0x20
+
+/* Configuration fields held in the register shadow */
+#define VL53L1X_SHADOW_ROI_CENTER		(1 << 0)
+#define VL53L1X_SHADOW_ROI_XY			(1 << 1)
+#define VL53L1X_SHADOW_TIMING_BUDGET	(1 << 2)
+#define VL53L1X_SHADOW_DISTANCE_MODE	(1 << 3)
+#define VL53L1X_SHADOW_INTER_MEAS		(1 << 4)
+#define VL53L1X_SHADOW_THRESHOLD		(1 << 5)
+#define VL53L1X_SHADOW_SIGNAL			(1 << 6)
+#define VL53L1X_SHADOW_SIGMA			(1 << 7)
+#define VL53L1X_SHADOW_POLARITY			(1 << 8)
+
+/* RAM copy of the configuration registers of a device, only the fields
+ * flagged in valid match the sensor */
+typedef struct {
+	bool used;
+	uint16_t dev;
+	uint16_t valid;
+	uint8_t roi_center;
+	uint16_t roi_x;
+	uint16_t roi_y;
+	uint16_t timing_budget;
+	uint16_t distance_mode;
+	uint16_t inter_measurement;
+	uint16_t threshold_low;
+	uint16_t threshold_high;
+	uint8_t threshold_window;
+	uint16_t signal;
+	uint16_t sigma;
+	uint8_t polarity;
+} vl53l1x_shadow_t;
+
+static vl53l1x_shadow_t _shadow[VL53L1X_CONFIG_SHADOW_SIZE];
+
+static vl53l1x_shadow_t *vl53l1x_shadow_get(uint16_t dev);
+static bool vl53l1x_shadow_has(const vl53l1x_shadow_t *shadow, uint16_t field);
+static void vl53l1x_decode_result(const VL53L1X_Result_t *vl53_result,
+		vl53l1x_result_t *result);
+static void vl53l1x_result_read_done(sl_status_t status, void *context);
+static void vl53l1x_result_clear_done(sl_status_t status, void *context);
+
 sl_status_t vl53l1x_init(uint16_t dev) {
+	/* The default configuration overwrites the shadowed registers */
+	vl53l1x_invalidate_shadow(dev);
 	return VL53L1X_SensorInit(dev);
 }
 
+void vl53l1x_invalidate_shadow(uint16_t dev) {
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+
+	if (NULL != shadow) {
+		shadow->valid = 0;
+	}
+}
+
+#ifndef VL53L1X_PLATFORM_EMULATOR
 sl_status_t vl53l1x_set_i2cspm_instance(sl_i2cspm_t *i2cspm_instance) {
 	if (NULL == i2cspm_instance) {
 		return SL_STATUS_INVALID_PARAMETER;
@@ -61,6 +116,7 @@ sl_status_t vl53l1x_set_i2cspm_instance(sl_i2cspm_t *i2cspm_instance) {
 
 	return SL_STATUS_OK;
 }
+#endif
 
 sl_status_t vl53l1x_start_ranging(uint16_t dev) {
 	return VL53L1X_StartRanging(dev);
@@ -71,7 +127,37 @@ sl_status_t vl53l1x_stop_ranging(uint16_t dev) {
 }
 
 sl_status_t vl53l1x_set_i2c_address(uint16_t dev, uint8_t new_address) {
-	return VL53L1X_SetI2CAddress(dev, new_address);
+	vl53l1x_shadow_t *shadow;
+	uint8_t i;
+	sl_status_t ret;
+
+	ret = VL53L1X_SetI2CAddress(dev, new_address);
+	if (SL_STATUS_OK == ret) {
+		/* The configuration follows the device to its new address */
+		for (i = 0; i < VL53L1X_CONFIG_SHADOW_SIZE; i++) {
+			if (_shadow[i].used && (_shadow[i].dev == (new_address >> 1))) {
+				_shadow[i].used = false;
+			}
+		}
+		shadow = vl53l1x_shadow_get(dev);
+		if (NULL != shadow) {
+			shadow->dev = new_address >> 1;
+		}
+	}
+	return ret;
+}
+
+sl_status_t vl53l1x_software_reset(uint16_t dev) {
+	sl_status_t ret;
+
+	/* The default configuration and address are back after the boot */
+	vl53l1x_invalidate_shadow(dev);
+	ret = VL53L1_WrByte(dev, SOFT_RESET, 0x00);
+	if (SL_STATUS_OK == ret) {
+		/* The transfer lasts longer than the 100 us reset pulse */
+		ret = VL53L1_WrByte(dev, SOFT_RESET, 0x01);
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_clear_interrupt(uint16_t dev) {
@@ -79,58 +165,183 @@ sl_status_t vl53l1x_clear_interrupt(uint16_t dev) {
 }
 
 sl_status_t vl53l1x_set_interrupt_polarity(uint16_t dev, uint8_t int_pol) {
-	return VL53L1X_SetInterruptPolarity(dev, int_pol);
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	sl_status_t ret;
+
+	int_pol &= 1;
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_POLARITY)
+			&& (shadow->polarity == int_pol)) {
+		return SL_STATUS_OK;
+	}
+	ret = VL53L1X_SetInterruptPolarity(dev, int_pol);
+	if ((SL_STATUS_OK == ret) && (NULL != shadow)) {
+		shadow->polarity = int_pol;
+		shadow->valid |= VL53L1X_SHADOW_POLARITY;
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_get_interrupt_polarity(uint16_t dev, uint8_t *int_pol) {
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	sl_status_t ret;
+
 	if (NULL == int_pol) {
 		return SL_STATUS_INVALID_PARAMETER;
 	}
-	return VL53L1X_GetInterruptPolarity(dev, int_pol);
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_POLARITY)) {
+		*int_pol = shadow->polarity;
+		return SL_STATUS_OK;
+	}
+	ret = VL53L1X_GetInterruptPolarity(dev, int_pol);
+	if ((SL_STATUS_OK == ret) && (NULL != shadow)) {
+		shadow->polarity = *int_pol;
+		shadow->valid |= VL53L1X_SHADOW_POLARITY;
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_check_for_data_ready(uint16_t dev, uint8_t *is_data_ready) {
+	uint8_t int_pol;
+	uint8_t tio_status;
+	sl_status_t ret;
+
 	if (NULL == is_data_ready) {
 		return SL_STATUS_INVALID_PARAMETER;
 	}
-	return VL53L1X_CheckForDataReady(dev, is_data_ready);
+	/* Same as VL53L1X_CheckForDataReady() with the polarity from the shadow,
+	 * a single register read per poll */
+	ret = vl53l1x_get_interrupt_polarity(dev, &int_pol);
+	if (SL_STATUS_OK == ret) {
+		ret = VL53L1_RdByte(dev, GPIO__TIO_HV_STATUS, &tio_status);
+	}
+	if (SL_STATUS_OK == ret) {
+		*is_data_ready = ((tio_status & 1) == int_pol) ? 1 : 0;
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_set_timing_budget_in_ms(uint16_t dev,
 		uint16_t timing_budget_in_ms) {
-	return VL53L1X_SetTimingBudgetInMs(dev, timing_budget_in_ms);
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	sl_status_t ret;
+
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_TIMING_BUDGET)
+			&& (shadow->timing_budget == timing_budget_in_ms)) {
+		return SL_STATUS_OK;
+	}
+	ret = VL53L1X_SetTimingBudgetInMs(dev, timing_budget_in_ms);
+	if (NULL != shadow) {
+		if (SL_STATUS_OK == ret) {
+			shadow->timing_budget = timing_budget_in_ms;
+			shadow->valid |= VL53L1X_SHADOW_TIMING_BUDGET;
+		} else {
+			/* The budget registers may be partially written */
+			shadow->valid &= ~VL53L1X_SHADOW_TIMING_BUDGET;
+		}
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_get_timing_budget_in_ms(uint16_t dev,
 		uint16_t *timing_budget_in_ms) {
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	sl_status_t ret;
+
 	if (NULL == timing_budget_in_ms) {
 		return SL_STATUS_INVALID_PARAMETER;
 	}
-	return VL53L1X_GetTimingBudgetInMs(dev, timing_budget_in_ms);
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_TIMING_BUDGET)) {
+		*timing_budget_in_ms = shadow->timing_budget;
+		return SL_STATUS_OK;
+	}
+	ret = VL53L1X_GetTimingBudgetInMs(dev, timing_budget_in_ms);
+	if ((SL_STATUS_OK == ret) && (NULL != shadow)) {
+		shadow->timing_budget = *timing_budget_in_ms;
+		shadow->valid |= VL53L1X_SHADOW_TIMING_BUDGET;
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_set_distance_mode(uint16_t dev, uint16_t distance_mode) {
-	return VL53L1X_SetDistanceMode(dev, distance_mode);
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	sl_status_t ret;
+
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_DISTANCE_MODE)
+			&& (shadow->distance_mode == distance_mode)) {
+		return SL_STATUS_OK;
+	}
+	/* The timing budget is written again with the new mode */
+	ret = VL53L1X_SetDistanceMode(dev, distance_mode);
+	if (NULL != shadow) {
+		if (SL_STATUS_OK == ret) {
+			shadow->distance_mode = distance_mode;
+			shadow->valid |= VL53L1X_SHADOW_DISTANCE_MODE;
+		} else {
+			shadow->valid &= ~(VL53L1X_SHADOW_DISTANCE_MODE
+					| VL53L1X_SHADOW_TIMING_BUDGET);
+		}
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_get_distance_mode(uint16_t dev, uint16_t *distance_mode) {
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	sl_status_t ret;
+
 	if (NULL == distance_mode) {
 		return SL_STATUS_INVALID_PARAMETER;
 	}
-	return VL53L1X_GetDistanceMode(dev, distance_mode);
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_DISTANCE_MODE)) {
+		*distance_mode = shadow->distance_mode;
+		return SL_STATUS_OK;
+	}
+	ret = VL53L1X_GetDistanceMode(dev, distance_mode);
+	if ((SL_STATUS_OK == ret) && (NULL != shadow)) {
+		shadow->distance_mode = *distance_mode;
+		shadow->valid |= VL53L1X_SHADOW_DISTANCE_MODE;
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_set_inter_measurement_in_ms(uint16_t dev,
 		uint32_t inter_measurement_in_ms) {
-	return VL53L1X_SetInterMeasurementInMs(dev, inter_measurement_in_ms);
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	sl_status_t ret;
+
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_INTER_MEAS)
+			&& (shadow->inter_measurement == inter_measurement_in_ms)) {
+		return SL_STATUS_OK;
+	}
+	ret = VL53L1X_SetInterMeasurementInMs(dev, inter_measurement_in_ms);
+	if (NULL != shadow) {
+		if ((SL_STATUS_OK == ret) && (inter_measurement_in_ms <= UINT16_MAX)) {
+			shadow->inter_measurement = inter_measurement_in_ms;
+			shadow->valid |= VL53L1X_SHADOW_INTER_MEAS;
+		} else {
+			shadow->valid &= ~VL53L1X_SHADOW_INTER_MEAS;
+		}
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_get_inter_measurement_in_ms(uint16_t dev,
 		uint16_t *inter_measurement_in_ms) {
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	sl_status_t ret;
+
 	if (NULL == inter_measurement_in_ms) {
 		return SL_STATUS_INVALID_PARAMETER;
 	}
-	return VL53L1X_GetInterMeasurementInMs(dev, inter_measurement_in_ms);
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_INTER_MEAS)) {
+		*inter_measurement_in_ms = shadow->inter_measurement;
+		return SL_STATUS_OK;
+	}
+	ret = VL53L1X_GetInterMeasurementInMs(dev, inter_measurement_in_ms);
+	if ((SL_STATUS_OK == ret) && (NULL != shadow)) {
+		shadow->inter_measurement = *inter_measurement_in_ms;
+		shadow->valid |= VL53L1X_SHADOW_INTER_MEAS;
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_get_boot_state(uint16_t dev, uint8_t *state) {
@@ -206,16 +417,100 @@ sl_status_t vl53l1x_get_result(uint16_t dev, vl53l1x_result_t *result) {
 	}
 
 	ret = VL53L1X_GetResult(dev, &vl53_result);
+	vl53l1x_decode_result(&vl53_result, result);
+
+	return ret;
+}
+
+sl_status_t vl53l1x_get_result_and_clear_interrupt(uint16_t dev,
+		vl53l1x_result_t *result) {
+	VL53L1X_Result_t vl53_result;
+	sl_status_t ret = SL_STATUS_OK;
+
+	if (NULL == result) {
+		return SL_STATUS_INVALID_PARAMETER;
+	}
 
-	result->status = vl53_result.Status;
-	result->ambient = vl53_result.Ambient;
-	result->distance = vl53_result.Distance;
-	result->number_per_spads = vl53_result.NumSPADs;
-	result->signal_per_spad = vl53_result.SigPerSPAD;
+	ret = VL53L1X_GetResultAndClearInterrupt(dev, &vl53_result);
+	vl53l1x_decode_result(&vl53_result, result);
 
 	return ret;
 }
 
+sl_status_t vl53l1x_get_result_and_clear_interrupt_async(uint16_t dev,
+		vl53l1x_result_request_t *request,
+		vl53l1x_result_callback_t callback, void *context) {
+	if ((NULL == request) || (NULL == callback)) {
+		return SL_STATUS_INVALID_PARAMETER;
+	}
+
+	request->dev = dev;
+	request->callback = callback;
+	request->context = context;
+
+	return vl53l1_platform_read_async(dev, VL53L1_RESULT__RANGE_STATUS,
+			request->raw, VL53L1_RESULT__BLOCK_SIZE,
+			vl53l1x_result_read_done, request);
+}
+
+static void vl53l1x_result_read_done(sl_status_t status, void *context) {
+	vl53l1x_result_request_t *request = (vl53l1x_result_request_t *) context;
+	const uint8_t clear = 0x01;
+
+	if (SL_STATUS_OK == status) {
+		// Chained here to keep the clear behind the read on the bus
+		status = vl53l1_platform_write_async(request->dev,
+				SYSTEM__INTERRUPT_CLEAR, &clear, 1,
+				vl53l1x_result_clear_done, request);
+	}
+	if (SL_STATUS_OK != status) {
+		request->callback(status, NULL, request->context);
+	}
+}
+
+static void vl53l1x_result_clear_done(sl_status_t status, void *context) {
+	vl53l1x_result_request_t *request = (vl53l1x_result_request_t *) context;
+	VL53L1X_Result_t vl53_result;
+
+	VL53L1X_DecodeResult(request->raw, &vl53_result);
+	vl53l1x_decode_result(&vl53_result, &request->result);
+	request->callback(status, &request->result, request->context);
+}
+
+static vl53l1x_shadow_t *vl53l1x_shadow_get(uint16_t dev) {
+	vl53l1x_shadow_t *free_entry = NULL;
+	uint8_t i;
+
+	for (i = 0; i < VL53L1X_CONFIG_SHADOW_SIZE; i++) {
+		if (_shadow[i].used && (_shadow[i].dev == dev)) {
+			return &_shadow[i];
+		}
+		if (!_shadow[i].used && (NULL == free_entry)) {
+			free_entry = &_shadow[i];
+		}
+	}
+	/* Devices beyond the shadow size access the registers directly */
+	if (NULL != free_entry) {
+		free_entry->used = true;
+		free_entry->dev = dev;
+		free_entry->valid = 0;
+	}
+	return free_entry;
+}
+
+static bool vl53l1x_shadow_has(const vl53l1x_shadow_t *shadow, uint16_t field) {
+	return (NULL != shadow) && (shadow->valid & field);
+}
+
+static void vl53l1x_decode_result(const VL53L1X_Result_t *vl53_result,
+		vl53l1x_result_t *result) {
+	result->status = vl53_result->Status;
+	result->ambient = vl53_result->Ambient;
+	result->distance = vl53_result->Distance;
+	result->number_per_spads = vl53_result->NumSPADs;
+	result->signal_per_spad = vl53_result->SigPerSPAD;
+}
+
 sl_status_t vl53l1x_set_offset(uint16_t dev, int16_t offset_value) {
 	return VL53L1X_SetOffset(dev, offset_value);
 }
@@ -240,74 +535,255 @@ sl_status_t vl53l1x_get_xtalk(uint16_t dev, uint16_t *x_talk_value) {
 
 sl_status_t vl53l1x_set_distance_threshold(uint16_t dev, uint16_t threshold_low,
 		uint16_t threshold_high, uint8_t window) {
-	return VL53L1X_SetDistanceThreshold(dev, threshold_low, threshold_high,
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	sl_status_t ret;
+
+	window &= 0x07;
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_THRESHOLD)
+			&& (shadow->threshold_low == threshold_low)
+			&& (shadow->threshold_high == threshold_high)
+			&& (shadow->threshold_window == window)) {
+		return SL_STATUS_OK;
+	}
+	ret = VL53L1X_SetDistanceThreshold(dev, threshold_low, threshold_high,
 			window, 0);
+	if (NULL != shadow) {
+		if (SL_STATUS_OK == ret) {
+			shadow->threshold_low = threshold_low;
+			shadow->threshold_high = threshold_high;
+			shadow->threshold_window = window;
+			shadow->valid |= VL53L1X_SHADOW_THRESHOLD;
+		} else {
+			shadow->valid &= ~VL53L1X_SHADOW_THRESHOLD;
+		}
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_set_distance_threshold_window_mode(uint16_t dev,
 		uint16_t *window) {
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+
 	if (NULL == window) {
 		return SL_STATUS_INVALID_PARAMETER;
 	}
-	return VL53L1X_GetDistanceMode(dev, window);
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_THRESHOLD)) {
+		*window = shadow->threshold_window;
+		return SL_STATUS_OK;
+	}
+	return VL53L1X_GetDistanceThresholdWindow(dev, window);
+}
+
+sl_status_t vl53l1x_clear_distance_threshold(uint16_t dev) {
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+
+	/* The window mode is overwritten, the next threshold is written again */
+	if (NULL != shadow) {
+		shadow->valid &= ~VL53L1X_SHADOW_THRESHOLD;
+	}
+	return VL53L1_WrByte(dev, SYSTEM__INTERRUPT_CONFIG_GPIO,
+			VL53L1X_INTERRUPT_NEW_SAMPLE_READY);
 }
 
 sl_status_t vl53l1x_get_distance_threshold_low(uint16_t dev, uint16_t *low) {
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+
 	if (NULL == low) {
 		return SL_STATUS_INVALID_PARAMETER;
 	}
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_THRESHOLD)) {
+		*low = shadow->threshold_low;
+		return SL_STATUS_OK;
+	}
 	return VL53L1X_GetDistanceThresholdLow(dev, low);
 }
 
 sl_status_t vl53l1x_get_distance_threshold_high(uint16_t dev, uint16_t *high) {
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+
 	if (NULL == high) {
 		return SL_STATUS_INVALID_PARAMETER;
 	}
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_THRESHOLD)) {
+		*high = shadow->threshold_high;
+		return SL_STATUS_OK;
+	}
 	return VL53L1X_GetDistanceThresholdHigh(dev, high);
 }
 
 sl_status_t vl53l1x_set_roi_xy(uint16_t dev, uint16_t x, uint16_t y) {
-	return VL53L1X_SetROI(dev, x, y);
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	sl_status_t ret;
+
+	/* Clamped as in VL53L1X_SetROI() */
+	x = (x > 16) ? 16 : x;
+	y = (y > 16) ? 16 : y;
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_ROI_XY)
+			&& (shadow->roi_x == x) && (shadow->roi_y == y)) {
+		return SL_STATUS_OK;
+	}
+	/* The ROI center is also moved to the optical center */
+	ret = VL53L1X_SetROI(dev, x, y);
+	if (NULL != shadow) {
+		shadow->valid &= ~VL53L1X_SHADOW_ROI_CENTER;
+		if (SL_STATUS_OK == ret) {
+			shadow->roi_x = x;
+			shadow->roi_y = y;
+			shadow->valid |= VL53L1X_SHADOW_ROI_XY;
+		} else {
+			shadow->valid &= ~VL53L1X_SHADOW_ROI_XY;
+		}
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_get_roi_xy(uint16_t dev, uint16_t *x, uint16_t *y) {
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	uint16_t roi_x = 0;
+	uint16_t roi_y = 0;
+	sl_status_t ret;
+
 	if (NULL == x && NULL == y) {
 		return SL_STATUS_INVALID_PARAMETER;
 	}
-	return VL53L1X_GetROI_XY(dev, x, y);
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_ROI_XY)) {
+		roi_x = shadow->roi_x;
+		roi_y = shadow->roi_y;
+		ret = SL_STATUS_OK;
+	} else {
+		ret = VL53L1X_GetROI_XY(dev, &roi_x, &roi_y);
+		if ((SL_STATUS_OK == ret) && (NULL != shadow)) {
+			shadow->roi_x = roi_x;
+			shadow->roi_y = roi_y;
+			shadow->valid |= VL53L1X_SHADOW_ROI_XY;
+		}
+	}
+	if (NULL != x) {
+		*x = roi_x;
+	}
+	if (NULL != y) {
+		*y = roi_y;
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_set_roi_center(uint16_t dev, uint8_t center) {
-	return VL53L1X_SetROICenter(dev, center);
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	sl_status_t ret;
+
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_ROI_CENTER)
+			&& (shadow->roi_center == center)) {
+		return SL_STATUS_OK;
+	}
+	ret = VL53L1X_SetROICenter(dev, center);
+	if (NULL != shadow) {
+		if (SL_STATUS_OK == ret) {
+			shadow->roi_center = center;
+			shadow->valid |= VL53L1X_SHADOW_ROI_CENTER;
+		} else {
+			shadow->valid &= ~VL53L1X_SHADOW_ROI_CENTER;
+		}
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_get_roi_center(uint16_t dev, uint8_t *center) {
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	sl_status_t ret;
+
 	if (NULL == center) {
 		return SL_STATUS_INVALID_PARAMETER;
 	}
-	return VL53L1X_GetROICenter(dev, center);
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_ROI_CENTER)) {
+		*center = shadow->roi_center;
+		return SL_STATUS_OK;
+	}
+	ret = VL53L1X_GetROICenter(dev, center);
+	if ((SL_STATUS_OK == ret) && (NULL != shadow)) {
+		shadow->roi_center = *center;
+		shadow->valid |= VL53L1X_SHADOW_ROI_CENTER;
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_set_signal_threshold(uint16_t dev, uint16_t signal) {
-	return VL53L1X_SetSignalThreshold(dev, signal);
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	sl_status_t ret;
+
+	/* The register holds the threshold divided by 8 */
+	signal &= ~0x07;
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_SIGNAL)
+			&& (shadow->signal == signal)) {
+		return SL_STATUS_OK;
+	}
+	ret = VL53L1X_SetSignalThreshold(dev, signal);
+	if (NULL != shadow) {
+		if (SL_STATUS_OK == ret) {
+			shadow->signal = signal;
+			shadow->valid |= VL53L1X_SHADOW_SIGNAL;
+		} else {
+			shadow->valid &= ~VL53L1X_SHADOW_SIGNAL;
+		}
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_get_signal_threshold(uint16_t dev, uint16_t *signal) {
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	sl_status_t ret;
+
 	if (NULL == signal) {
 		return SL_STATUS_INVALID_PARAMETER;
 	}
-	return VL53L1X_GetSignalThreshold(dev, signal);
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_SIGNAL)) {
+		*signal = shadow->signal;
+		return SL_STATUS_OK;
+	}
+	ret = VL53L1X_GetSignalThreshold(dev, signal);
+	if ((SL_STATUS_OK == ret) && (NULL != shadow)) {
+		shadow->signal = *signal;
+		shadow->valid |= VL53L1X_SHADOW_SIGNAL;
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_set_sigma_threshold(uint16_t dev, uint16_t sigma) {
-	return VL53L1X_SetSigmaThreshold(dev, sigma);
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	sl_status_t ret;
+
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_SIGMA)
+			&& (shadow->sigma == sigma)) {
+		return SL_STATUS_OK;
+	}
+	ret = VL53L1X_SetSigmaThreshold(dev, sigma);
+	if (NULL != shadow) {
+		if (SL_STATUS_OK == ret) {
+			shadow->sigma = sigma;
+			shadow->valid |= VL53L1X_SHADOW_SIGMA;
+		} else {
+			shadow->valid &= ~VL53L1X_SHADOW_SIGMA;
+		}
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_get_sigma_threshold(uint16_t dev, uint16_t *sigma) {
+	vl53l1x_shadow_t *shadow = vl53l1x_shadow_get(dev);
+	sl_status_t ret;
+
 	if (NULL == sigma) {
 		return SL_STATUS_INVALID_PARAMETER;
 	}
-	return VL53L1X_GetSigmaThreshold(dev, sigma);
+	if (vl53l1x_shadow_has(shadow, VL53L1X_SHADOW_SIGMA)) {
+		*sigma = shadow->sigma;
+		return SL_STATUS_OK;
+	}
+	ret = VL53L1X_GetSigmaThreshold(dev, sigma);
+	if ((SL_STATUS_OK == ret) && (NULL != shadow)) {
+		shadow->sigma = *sigma;
+		shadow->valid |= VL53L1X_SHADOW_SIGMA;
+	}
+	return ret;
 }
 
 sl_status_t vl53l1x_start_temperature_update(uint16_t dev) {
@@ -34,11 +34,26 @@
  * Silicon Labs may update projects from time to time.
  ******************************************************************************/
 #include <stdio.h>
+#include <string.h>
 #include "em_common.h"
+#include "em_core.h"
 #include "app_assert.h"
 #include "sl_bluetooth.h"
+#include "gpiointerrupt.h"
 #include "vl53l1x_config.h"
 #include "vl53l1x.h"
+#include "vl53l1_platform.h"
+#ifdef VL53L1X_PLATFORM_EMULATOR
+#include "vl53l1_platform_emul.h"
+#else
+#include "nvm3_default.h"
+#endif
+#if !defined(VL53L1X_PLATFORM_EMULATOR) \
+  || ((VL53L1X_CONFIG_SENSOR_COUNT > 1) && (VL53L1X_CONFIG_MERGE_WINDOW_MS > 0))
+#include "sl_sleeptimer.h"
+#endif
+#include "people_counting.h"
+#include "people_counting_trace.h"
 #include "vl53l1x_app.h"
 
 // -----------------------------------------------------------------------------
@@ -68,34 +83,232 @@
 // -----------------------------------------------------------------------------
 // Defines
 
-#define NOBODY                    0
-#define SOMEONE                   1
-#define LEFT                      0
-#define RIGHT                     1
-
-#define DISTANCES_ARRAY_SIZE      10   // nb of samples
 #define DISTANCE_MODE             VL53L1X_DISTANCE_MODE_LONG
 
-#define FRONT_ZONE_CENTER                            175
-#define BACK_ZONE_CENTER                             231
+#define INTERRUPT_ACTIVE_LOW      0
+
+#define RESULT_READ_IDLE          0
+#define RESULT_READ_PENDING       1
+#define RESULT_READ_DONE          2
+
+#define NO_SENSOR                 0xFF
+
+// XSHUT is held low XSHUT_LOW_MS to power a sensor down. The sensor boots
+// in about 1.2 ms, its boot state is read every BOOT_POLL_MS for at most
+// BOOT_TIMEOUT_MS.
+#define XSHUT_LOW_MS              2
+#define BOOT_POLL_MS              1
+#define BOOT_TIMEOUT_MS           10
+
+// Front and back zone of each lane are scanned in turn
+#define ZONE_COUNT                (VL53L1X_CONFIG_LANE_COUNT \
+                                   * PEOPLE_COUNTING_ZONES)
+
+#if (VL53L1X_CONFIG_TRACE_SIZE > 0) \
+  && (VL53L1X_CONFIG_SENSOR_COUNT * ZONE_COUNT > PEOPLE_COUNTING_TRACE_ZONES)
+#error "Too many zones to tell apart in the trace"
+#endif
+
+// The sensor starts the next ranging as soon as a result is ready and the
+// ROI is latched on start, so a new zone is only used by the ranging after
+// the next one. Sensors taking turns are stopped in between.
+#if (VL53L1X_CONFIG_SENSOR_COUNT > 1)
+#define ZONE_LOOKAHEAD            1
+#else
+#define ZONE_LOOKAHEAD            2
+#endif
+
+// Sampling rate of the doorway
+#define ACTIVITY_ACTIVE           0    // rangings back to back
+#define ACTIVITY_IDLE             1    // rangings spaced by the idle period
+
+// The idle rangings only signal someone closer than a threshold, this needs
+// the sensor to range all the time
+#if (VL53L1X_CONFIG_IDLE_PERIOD_MS > 0)           \
+  && (VL53L1X_CONFIG_IDLE_THRESHOLD_WAKE == 1)     \
+  && (VL53L1X_CONFIG_SENSOR_COUNT == 1)
+#define IDLE_THRESHOLD_WAKE       1
+#else
+#define IDLE_THRESHOLD_WAKE       0
+#endif
+#define THRESHOLD_WINDOW_BELOW    0
+
+#define FULL_ROI_SIZE             16
+#define FULL_ROI_CENTER           199  // center of the full SPAD array
+
+// A sensor is recovered after HEALTH_BUS_ERRORS failed transfers in a row,
+// HEALTH_FAILURE_PCT % of hardware failures among HEALTH_WINDOW rangings of
+// a zone, valid rangings of a zone which do not change for HEALTH_STUCK_MS,
+// or no result for HEALTH_SILENCE_MS. It is configured again first, then
+// reset, and failed after HEALTH_RECOVERY_MAX recoveries without
+// HEALTH_STABLE_MS of rangings in between. Consecutive recoveries wait
+// HEALTH_BACKOFF_MS, doubled each time, a failed sensor is reset again every
+// HEALTH_RETRY_MS.
+#define HEALTH_BUS_ERRORS         5
+#define HEALTH_WINDOW             100
+#define HEALTH_FAILURE_PCT        90
+#define HEALTH_STUCK_MS           60000
+#define HEALTH_SILENCE_MS         2000
+#define HEALTH_STABLE_MS          60000
+#define HEALTH_BACKOFF_MS         1000
+#define HEALTH_RETRY_MS           60000
+#define HEALTH_RECOVERY_MAX       4
+
+#define HEALTH_FAULT_NONE         0
+#define HEALTH_FAULT_BUS          1
+#define HEALTH_FAULT_FAILURES     2
+#define HEALTH_FAULT_STUCK        3
+#define HEALTH_FAULT_SILENCE      4
+
+#define CALIBRATION_VERSION       1
+#define CALIBRATION_SAMPLES       16   // floor samples per zone
+#define CALIBRATION_THRESHOLD_PCT 80   // zone threshold in % of the floor
+#define CALIBRATION_OFFSET        (1 << 0)
+#define CALIBRATION_XTALK         (1 << 1)
+
+// -----------------------------------------------------------------------------
+// Private types
+
+// Region of interest of a zone
+typedef struct {
+  uint8_t center;
+  uint8_t width;
+  uint8_t height;
+} vl53l1x_app_zone_t;
+
+// Rangings of a zone watched for sensor faults
+typedef struct {
+  uint8_t rangings;         // rangings of the current window
+  uint8_t failures;         // hardware failures among them
+  uint16_t distance;        // previous valid ranging
+  uint16_t signal;
+  uint32_t changed_ms;      // last valid ranging which differed
+} vl53l1x_app_zone_health_t;
+
+// One sensor watching the lanes of a doorway
+typedef struct {
+  uint16_t addr;
+  uint8_t zone;
+  people_counting_t lanes[VL53L1X_CONFIG_LANE_COUNT];
+  vl53l1x_app_zone_health_t zone_health[ZONE_COUNT];
+  uint8_t bus_errors;       // failed transfers in a row
+  uint8_t fault;            // fault to recover from
+  uint8_t recoveries;       // recoveries without a stable period
+  uint32_t recovery_ms;     // last recovery
+  uint32_t result_ms;       // last result or start of ranging
+} vl53l1x_app_sensor_t;
+
+// Calibration stored in NVM3
+typedef struct {
+  uint8_t version;
+  uint8_t flags;
+  int16_t offset[VL53L1X_CONFIG_SENSOR_COUNT];
+  uint16_t xtalk[VL53L1X_CONFIG_SENSOR_COUNT];
+  uint16_t threshold[VL53L1X_CONFIG_SENSOR_COUNT][ZONE_COUNT];
+} vl53l1x_app_calibration_t;
 
 // -----------------------------------------------------------------------------
 // Private variables
 
-static const uint8_t roi_center[2] = {FRONT_ZONE_CENTER, BACK_ZONE_CENTER};
-static uint8_t zone = 0;
+static const vl53l1x_app_zone_t zones[ZONE_COUNT] = VL53L1X_CONFIG_ZONES;
+static const uint16_t sensor_addr[VL53L1X_CONFIG_SENSOR_COUNT] =
+  VL53L1X_CONFIG_SENSOR_ADDRS;
+static vl53l1x_app_sensor_t sensors[VL53L1X_CONFIG_SENSOR_COUNT];
+// Only this sensor is ranging, the others wait for their turn to avoid
+// cross-talk between the emitters
+static volatile uint8_t active_sensor = 0;
 static uint16_t vl53l1x_min_distance;
 static uint16_t vl53l1x_max_distance;
 static uint16_t measured_distance = 0;
+static uint16_t timing_budget_ms;
+
+#if (VL53L1X_CONFIG_IDLE_PERIOD_MS > 0)
+static uint8_t activity = ACTIVITY_ACTIVE;
+static uint32_t activity_ms;    // last sample with someone, or idle start
+static uint32_t wake_ms;        // sample which found someone while idle
+static bool wake_pending = false;
+static vl53l1x_app_activity_stats_t activity_stats;
+#endif
 
 static uint32_t invalid_count = 0;
 
-static uint16_t vl53l1x_distance_threshold;
+static vl53l1x_app_health_t health = VL53L1X_APP_HEALTH_OK;
+static vl53l1x_app_health_stats_t health_stats;
+
+static vl53l1x_app_calibration_t calibration;
+static bool calibrated = false;
+static bool calibrating = false;
+static uint16_t floor_samples[VL53L1X_CONFIG_SENSOR_COUNT][ZONE_COUNT]
+                            [CALIBRATION_SAMPLES];
+static uint8_t floor_sample_count[VL53L1X_CONFIG_SENSOR_COUNT][ZONE_COUNT];
+
+#if (VL53L1X_CONFIG_TRACE_SIZE > 0)
+static uint8_t trace_buffer[VL53L1X_CONFIG_TRACE_SIZE];
+static people_counting_trace_t trace;
+#endif
+
+static vl53l1x_result_request_t result_request;
+static volatile uint8_t result_read_state = RESULT_READ_IDLE;
+static volatile sl_status_t result_read_status;
 
 // -----------------------------------------------------------------------------
 // Private function declarations
 
-static void process_people_counting_data(int16_t distance, uint8_t zone);
+static sl_status_t wait_boot(uint16_t addr);
+static void delay_ms(uint32_t ms);
+static void init_sensor(uint8_t index);
+static sl_status_t configure_sensor(uint8_t index);
+static sl_status_t set_timing_budget(uint16_t addr,
+                                     uint16_t timing_budget,
+                                     uint16_t inter_measurement);
+static uint16_t get_timing_budget(void);
+static uint16_t get_inter_measurement(void);
+static sl_status_t set_zone(uint16_t addr, uint8_t zone);
+static sl_status_t start_zone_scan(vl53l1x_app_sensor_t *sensor);
+static void process_result(vl53l1x_app_sensor_t *sensor,
+                           const vl53l1x_result_t *result);
+static void dispatch_event(uint8_t index, people_counting_event_t event);
+static void add_floor_sample(uint8_t index, uint8_t zone, uint16_t distance);
+static void finish_calibration(void);
+static uint16_t get_median(uint16_t *samples, uint8_t count);
+static void apply_thresholds(uint8_t index);
+static sl_status_t load_calibration(void);
+static sl_status_t store_calibration(void);
+#if (VL53L1X_CONFIG_TRACE_SIZE > 0)
+static void add_trace_record(uint8_t index,
+                             uint8_t zone,
+                             uint8_t status,
+                             const people_counting_sample_t *sample);
+#endif
+#if (VL53L1X_CONFIG_IDLE_PERIOD_MS > 0)
+static void update_activity(void);
+static void wake_up(bool measured);
+static void set_activity(uint8_t next);
+#endif
+#if (IDLE_THRESHOLD_WAKE == 1)
+static sl_status_t start_threshold_wake(vl53l1x_app_sensor_t *sensor);
+#endif
+static void update_zone_health(vl53l1x_app_sensor_t *sensor,
+                               const vl53l1x_result_t *result,
+                               bool failure);
+static void add_bus_error(vl53l1x_app_sensor_t *sensor);
+static void handle_fault(vl53l1x_app_sensor_t *sensor);
+static uint32_t get_recovery_delay(const vl53l1x_app_sensor_t *sensor);
+static void recover_sensor(vl53l1x_app_sensor_t *sensor);
+static sl_status_t reset_sensor(uint8_t index);
+static void update_health(void);
+static uint32_t get_time_ms(void);
+static sl_status_t start_result_read(void);
+static void result_read_callback(sl_status_t status,
+                                 const vl53l1x_result_t *result,
+                                 void *context);
+#if (VL53L1X_CONFIG_INT_ENABLE == 1)
+static void data_ready_interrupt_callback(uint8_t int_no);
+#endif
+#if (VL53L1X_CONFIG_SENSOR_COUNT > 1)
+static void set_xshut(uint8_t index, bool enable);
+static void switch_active_sensor(void);
+#endif
 
 // -----------------------------------------------------------------------------
 // Public function definitions
@@ -109,50 +322,91 @@ void vl53l1x_app_init(uint16_t min_distance,
                      uint16_t timing_budget)
 {
   sl_status_t sc;
-  uint8_t boot_state;
-  uint16_t sensor_id;
+  uint8_t i;
+  uint8_t j;
 
   vl53l1x_min_distance = min_distance;
   vl53l1x_max_distance = max_distance;
-  vl53l1x_distance_threshold = distance_threshold;
   log_info("distance: min %d, max %d, threshold %d\r\n",
-           vl53l1x_min_distance, vl53l1x_max_distance, vl53l1x_distance_threshold);
+           vl53l1x_min_distance, vl53l1x_max_distance, distance_threshold);
   log_info("timing budget: %d\r\n", timing_budget);
+  timing_budget_ms = timing_budget;
+#if (VL53L1X_CONFIG_TRACE_SIZE > 0)
+  people_counting_trace_init(&trace, trace_buffer, sizeof(trace_buffer));
+#endif
 
-  sc = vl53l1x_get_sensor_id(VL53L1X_ADDR, &sensor_id);
-  app_assert_status(sc);
-  log_info("VL53L1X Model ID: %X\r\n", sensor_id);
+#if (VL53L1X_CONFIG_SENSOR_COUNT > 1)
+  // Hold all the sensors in reset, they all answer to the default address
+  for (i = 0; i < VL53L1X_CONFIG_SENSOR_COUNT; i++) {
+    set_xshut(i, false);
+  }
+  // Power cycle them, after a warm reset they still have the moved address
+  delay_ms(XSHUT_LOW_MS);
+#endif
 
-  // Wait for boot the VL53L1X sensor up
-  do {
-    sc = vl53l1x_get_boot_state(VL53L1X_ADDR, &boot_state);
+  for (i = 0; i < VL53L1X_CONFIG_SENSOR_COUNT; i++) {
+#if (VL53L1X_CONFIG_SENSOR_COUNT > 1)
+    // Release the sensors one by one and move them to their own address
+    set_xshut(i, true);
+#endif
+    sc = wait_boot(VL53L1X_ADDR);
     app_assert_status(sc);
-  } while(boot_state == 0);
-  log_info("VL53L1X booted\r\n");
-
-  // Initialize VL53L1X
-  sc = vl53l1x_init(VL53L1X_ADDR);
-  app_assert_status(sc);
-
-  // Configure distance mode to LONG distance mode
-  sc = vl53l1x_set_distance_mode(VL53L1X_ADDR, DISTANCE_MODE);
-  app_assert_status(sc);
+    if (sensor_addr[i] != VL53L1X_ADDR) {
+      sc = vl53l1x_set_i2c_address(VL53L1X_ADDR, sensor_addr[i] << 1);
+      app_assert_status(sc);
+    }
 
-  // Set timing budget
-  vl53l1x_app_change_timing_budget_in_ms(timing_budget);
+    sensors[i].addr = sensor_addr[i];
+    sensors[i].zone = 0;
+    for (j = 0; j < VL53L1X_CONFIG_LANE_COUNT; j++) {
+      people_counting_init(&sensors[i].lanes[j], distance_threshold);
+    }
+    init_sensor(i);
+  }
 
-  // Set region of interest center
-  sc = vl53l1x_set_roi_center(VL53L1X_ADDR, BACK_ZONE_CENTER);
-  app_assert_status(sc);
+  // Use the calibration of the installation if any
+  if (SL_STATUS_OK == load_calibration()) {
+    for (i = 0; i < VL53L1X_CONFIG_SENSOR_COUNT; i++) {
+      if (calibration.flags & CALIBRATION_OFFSET) {
+        sc = vl53l1x_set_offset(sensors[i].addr, calibration.offset[i]);
+        app_assert_status(sc);
+      }
+      if (calibration.flags & CALIBRATION_XTALK) {
+        sc = vl53l1x_set_xtalk(sensors[i].addr, calibration.xtalk[i]);
+        app_assert_status(sc);
+      }
+      apply_thresholds(i);
+    }
+    calibrated = true;
+    log_info("Calibration loaded\r\n");
+  }
 
-  // Set region of interest SPADs 8x16
-  sc = vl53l1x_set_roi_xy(VL53L1X_ADDR, 8, 16);
-  app_assert_status(sc);
+#if (VL53L1X_CONFIG_INT_ENABLE == 1)
+  // GPIO1 of all the sensors are open drain on the same line, only the
+  // active sensor drives it
+  GPIO_PinModeSet(VL53L1X_CONFIG_INT_PORT,
+                  VL53L1X_CONFIG_INT_PIN,
+                  gpioModeInputPullFilter,
+                  1);
+  GPIOINT_CallbackRegister(VL53L1X_CONFIG_INT_PIN,
+                           data_ready_interrupt_callback);
+  // Falling edge, enabled on start of sampling
+  GPIO_ExtIntConfig(VL53L1X_CONFIG_INT_PORT,
+                    VL53L1X_CONFIG_INT_PIN,
+                    VL53L1X_CONFIG_INT_PIN,
+                    false,
+                    true,
+                    false);
+#endif
 
   // Start ranging
   log_info("Start ranging...\r\n");
-  sc = vl53l1x_start_ranging(VL53L1X_ADDR);
+  active_sensor = 0;
+  sc = start_zone_scan(&sensors[active_sensor]);
   app_assert_status(sc);
+#if (VL53L1X_CONFIG_IDLE_PERIOD_MS > 0)
+  activity_ms = get_time_ms();
+#endif
 }
 
 /**************************************************************************//**
@@ -161,69 +415,57 @@ void vl53l1x_app_init(uint16_t min_distance,
 void vl53l1x_app_process_sampling_data(void)
 {
   uint8_t is_data_ready = 0;
-  uint8_t range_status = 0;
-  uint16_t distance = 0;
-  uint16_t signal_per_spad;
+  vl53l1x_app_sensor_t *sensor;
+  vl53l1x_result_t result;
   sl_status_t sc;
 
-  sc = vl53l1x_check_for_data_ready(VL53L1X_ADDR, &is_data_ready);
-  if(SL_STATUS_OK != sc)  return; // app_assert_status(sc);
-  if (is_data_ready) {
-    sc += vl53l1x_get_range_status(VL53L1X_ADDR, &range_status);
-    sc += vl53l1x_get_distance(VL53L1X_ADDR, &distance);
-    sc += vl53l1x_get_signal_per_spad(VL53L1X_ADDR, &signal_per_spad);
-    sc += vl53l1x_clear_interrupt(VL53L1X_ADDR);
-    if(SL_STATUS_OK != sc)  {
+  if (RESULT_READ_DONE == result_read_state) {
+    // The next readout may reuse the request as soon as it is released
+    sensor = &sensors[active_sensor];
+    result = result_request.result;
+    sc = result_read_status;
+#if (VL53L1X_CONFIG_SENSOR_COUNT > 1)
+    switch_active_sensor();
+#endif
+    result_read_state = RESULT_READ_IDLE;
+    if (SL_STATUS_OK != sc) {
       log_error("Error while reading device: 0x%x\r\n", sc);
-      return; // app_assert_status(sc);
+      add_bus_error(sensor);
+    } else {
+      sensor->bus_errors = 0;
+      sensor->result_ms = get_time_ms();
+      process_result(sensor, &result);
     }
-    measured_distance = distance;
-
-    switch (range_status) {
-      case 0:  // VL53L1_RANGESTATUS_RANGE_VALID Ranging measurement is valid
-      case 4:  // VL53L1_RANGESTATUS_OUTOFBOUNDS_ FAIL Raised when phase
-               // is out of bounds
-      case 7:  // VL53L1_RANGESTATUS_WRAP_TARGET_ FAIL Wrapped target,
-               // not matching phases
-        // wraparound case see the explanation at the constants definition place
-        if (distance <= vl53l1x_min_distance)
-          distance = vl53l1x_max_distance + vl53l1x_min_distance;
-        break;
-      case 1:  // VL53L1_RANGESTATUS_SIGMA_FAIL Raised if sigma estimator check
-               // is above the internal defined threshold
-      case 2:  // VL53L1_RANGESTATUS_SIGNAL_FAIL Raised if signal value
-               // is below the internal defined threshold
-      case 5:  // VL53L1_RANGESTATUS_HARDWARE_FAIL Raised in case
-               // of HW or VCSEL failure
-      case 8:  // VL53L1_RANGESTATUS_PROCESSING_FAIL
-               // Internal algorithm underflow or overflow
-      case 14: // VL53L1_RANGESTATUS_RANGE_INVALID The reported range is invalid
-        distance = vl53l1x_max_distance;
-        break;
-      case 13: // The 13 simply means the hardware was not able to select
-               // that particular ROI with that specific center location.
-               // This situation happens a lot when moving the ROI
-               // as close to the edge
-               // as possible. To avoid it, reduce the X or Y
-               // dimensions or move the ROI_Center one SPAD toward the middle.
-        app_assert(0, "The configuration is not correct: see UM2555\r\n");
-        break;
-      default:
-        log_error("Unknown range status: %d\r\n", range_status);
-        break;
-    }
-    // add new ranged distance sample to the people counting algorithm
-    process_people_counting_data(distance, zone);
-
-
-    zone++;
-    zone %= 2;
+    handle_fault(sensor);
+#if (VL53L1X_CONFIG_INT_ENABLE != 1)
+    return;
+#endif
+  }
 
-    sc = vl53l1x_set_roi_center(VL53L1X_ADDR, roi_center[zone]);
-    if (SL_STATUS_OK != sc) {
-      log_error("Error in changing center of ROI: 0x%x\r\n", sc);
+#if (VL53L1X_CONFIG_INT_ENABLE == 1)
+  // The line stays asserted until the interrupt is cleared, catch a data
+  // ready missed while the previous result was waiting to be processed
+  is_data_ready = !GPIO_PinInGet(VL53L1X_CONFIG_INT_PORT,
+                                 VL53L1X_CONFIG_INT_PIN);
+#else
+  if (RESULT_READ_IDLE != result_read_state) {
+    // The previous result is still on the bus
+    return;
+  }
+  sc = vl53l1x_check_for_data_ready(sensors[active_sensor].addr,
+                                    &is_data_ready);
+  if (SL_STATUS_OK != sc) {
+    add_bus_error(&sensors[active_sensor]);
+  }
+#endif
+  if (is_data_ready) {
+    sc = start_result_read();
+    if(SL_STATUS_OK != sc)  {
+      log_error("Error while reading device: 0x%x\r\n", sc);
+      add_bus_error(&sensors[active_sensor]);
     }
   }
+  handle_fault(&sensors[active_sensor]);
 }
 
 /**************************************************************************//**
@@ -234,6 +476,23 @@ uint16_t vl53l1x_app_get_current_measured_distance(void)
   return measured_distance;
 }
 
+/**************************************************************************//**
+ * VL53L1X Get Rejected Path Count.
+ *****************************************************************************/
+uint32_t vl53l1x_app_get_rejected_path_count(people_counting_reject_t type)
+{
+  uint32_t count = 0;
+  uint8_t i;
+  uint8_t j;
+
+  for (i = 0; i < VL53L1X_CONFIG_SENSOR_COUNT; i++) {
+    for (j = 0; j < VL53L1X_CONFIG_LANE_COUNT; j++) {
+      count += sensors[i].lanes[j].rejects[type];
+    }
+  }
+  return count;
+}
+
 /**************************************************************************//**
  * VL53L1X Get Invalid Count.
  *****************************************************************************/
@@ -242,158 +501,1097 @@ uint32_t vl53l1x_app_get_invalid_count(void)
   return invalid_count;
 }
 
+/**************************************************************************//**
+ * VL53L1X Dump Trace.
+ *****************************************************************************/
+void vl53l1x_app_dump_trace(void)
+{
+#if (VL53L1X_CONFIG_TRACE_SIZE > 0)
+  people_counting_trace_cursor_t cursor;
+  people_counting_trace_record_t record;
+  uint8_t i;
+  uint8_t z;
+
+  log_info("Trace: %lu samples dropped\r\n", (unsigned long)trace.dropped);
+  for (i = 0; i < VL53L1X_CONFIG_SENSOR_COUNT; i++) {
+    for (z = 0; z < ZONE_COUNT; z++) {
+      // threshold,sensor,lane,zone,mm
+      log_info("threshold,%d,%d,%d,%d\r\n",
+               i,
+               z / PEOPLE_COUNTING_ZONES,
+               z % PEOPLE_COUNTING_ZONES,
+               sensors[i].lanes[z / PEOPLE_COUNTING_ZONES]
+               .distance_threshold[z % PEOPLE_COUNTING_ZONES]);
+    }
+  }
+  people_counting_trace_rewind(&trace, &cursor);
+  while (people_counting_trace_read(&trace, &cursor, &record)) {
+    // trace,ms,sensor,lane,zone,status,valid,distance,signal,ambient
+    log_info("trace,%lu,%d,%d,%d,%d,%d,%u,%u,%u\r\n",
+             (unsigned long)record.time_ms,
+             record.zone / ZONE_COUNT,
+             (record.zone % ZONE_COUNT) / PEOPLE_COUNTING_ZONES,
+             record.zone % PEOPLE_COUNTING_ZONES,
+             record.status,
+             record.sample.valid,
+             record.sample.distance,
+             record.sample.signal_per_spad,
+             record.sample.ambient_per_spad);
+  }
+#else
+  log_info("Trace disabled\r\n");
+#endif
+}
+
+/**************************************************************************//**
+ * VL53L1X Start Calibration.
+ *****************************************************************************/
+void vl53l1x_app_start_calibration(void)
+{
+  memset(floor_sample_count, 0, sizeof(floor_sample_count));
+  calibrating = true;
+  log_info("Floor calibration started\r\n");
+#if (VL53L1X_CONFIG_IDLE_PERIOD_MS > 0)
+  // The floor is sampled at full rate
+  if (ACTIVITY_IDLE == activity) {
+    wake_up(false);
+  }
+#endif
+}
+
+/**************************************************************************//**
+ * VL53L1X Is Calibrated.
+ *****************************************************************************/
+bool vl53l1x_app_is_calibrated(void)
+{
+  return calibrated;
+}
+
+/**************************************************************************//**
+ * VL53L1X Calibrate Offset And Crosstalk.
+ *****************************************************************************/
+sl_status_t vl53l1x_app_calibrate_offset_and_xtalk(uint16_t target_distance)
+{
+  sl_status_t sc;
+  uint8_t i;
+
+#if (VL53L1X_CONFIG_IDLE_PERIOD_MS > 0)
+  // The calibration needs a data ready on every ranging
+  if (ACTIVITY_IDLE == activity) {
+    wake_up(false);
+  }
+#endif
+  // Let a readout in progress complete in EM1, its result is dropped
+  vl53l1_platform_wait_idle();
+  result_read_state = RESULT_READ_IDLE;
+
+  sc = vl53l1x_stop_ranging(sensors[active_sensor].addr);
+  for (i = 0; (SL_STATUS_OK == sc) && (i < VL53L1X_CONFIG_SENSOR_COUNT); i++) {
+    // Offset and crosstalk are measured on the full SPAD array
+    sc = vl53l1x_set_roi_xy(sensors[i].addr, FULL_ROI_SIZE, FULL_ROI_SIZE);
+    if (SL_STATUS_OK == sc) {
+      sc = vl53l1x_set_roi_center(sensors[i].addr, FULL_ROI_CENTER);
+    }
+    if (SL_STATUS_OK == sc) {
+      sc = vl53l1x_calibrate_offset(sensors[i].addr,
+                                    target_distance,
+                                    &calibration.offset[i]);
+    }
+    if (SL_STATUS_OK == sc) {
+      sc = vl53l1x_calibrate_xtalk(sensors[i].addr,
+                                   target_distance,
+                                   &calibration.xtalk[i]);
+    }
+    if (SL_STATUS_OK == sc) {
+      log_info("Sensor %d: offset %d mm, xtalk %d cps\r\n",
+               i, calibration.offset[i], calibration.xtalk[i]);
+      sc = set_zone(sensors[i].addr, sensors[i].zone);
+    }
+  }
+  if (SL_STATUS_OK != sc) {
+    log_error("Offset and xtalk calibration error: 0x%x\r\n", sc);
+    return sc;
+  }
+
+  calibration.flags |= CALIBRATION_OFFSET | CALIBRATION_XTALK;
+  // Stored with the zone thresholds, now or at the end of their calibration
+  if (calibrated) {
+    sc = store_calibration();
+  }
+  if (SL_STATUS_OK == sc) {
+    sc = start_zone_scan(&sensors[active_sensor]);
+  }
+  return sc;
+}
+
+/**************************************************************************//**
+ * VL53L1X Start Data Ready Interrupt.
+ *****************************************************************************/
+void vl53l1x_app_start_data_ready_interrupt(void)
+{
+#if (VL53L1X_CONFIG_INT_ENABLE == 1)
+  GPIO_IntClear(1 << VL53L1X_CONFIG_INT_PIN);
+  GPIO_IntEnable(1 << VL53L1X_CONFIG_INT_PIN);
+#endif
+}
+
+/**************************************************************************//**
+ * VL53L1X Stop Data Ready Interrupt.
+ *****************************************************************************/
+void vl53l1x_app_stop_data_ready_interrupt(void)
+{
+#if (VL53L1X_CONFIG_INT_ENABLE == 1)
+  GPIO_IntDisable(1 << VL53L1X_CONFIG_INT_PIN);
+#endif
+}
+
 /**************************************************************************//**
  * VL53L1X Change Timing Budget.
  *****************************************************************************/
 void vl53l1x_app_change_timing_budget_in_ms(uint16_t timing_budget)
+{
+  uint16_t inter_measurement;
+  uint8_t i;
+
+  timing_budget_ms = timing_budget;
+  inter_measurement = get_inter_measurement();
+  for (i = 0; i < VL53L1X_CONFIG_SENSOR_COUNT; i++) {
+    set_timing_budget(sensors[i].addr, get_timing_budget(), inter_measurement);
+  }
+}
+
+/**************************************************************************//**
+ * VL53L1X Check Health.
+ *****************************************************************************/
+void vl53l1x_app_check_health(void)
+{
+  uint32_t now = get_time_ms();
+  vl53l1x_app_sensor_t *sensor = &sensors[active_sensor];
+  uint8_t i;
+
+#if (IDLE_THRESHOLD_WAKE == 1)
+  // The idle sensor only signals someone below the threshold
+  if (ACTIVITY_IDLE == activity) {
+    sensor->result_ms = now;
+  }
+#endif
+  // Only the active sensor is ranging
+  if ((now - sensor->result_ms) >= HEALTH_SILENCE_MS) {
+    sensor->fault = HEALTH_FAULT_SILENCE;
+  }
+  for (i = 0; i < VL53L1X_CONFIG_SENSOR_COUNT; i++) {
+    sensor = &sensors[i];
+    if ((HEALTH_FAULT_NONE == sensor->fault)
+        && sensor->recoveries
+        && ((now - sensor->recovery_ms) >= HEALTH_STABLE_MS)
+        && ((now - sensor->result_ms) < HEALTH_SILENCE_MS)) {
+      // Ranging correctly since the last recovery
+      sensor->recoveries = 0;
+      log_info("Sensor %d recovered\r\n", i);
+    }
+    handle_fault(sensor);
+  }
+  update_health();
+}
+
+/**************************************************************************//**
+ * VL53L1X Get Health.
+ *****************************************************************************/
+vl53l1x_app_health_t vl53l1x_app_get_health(void)
+{
+  return health;
+}
+
+/**************************************************************************//**
+ * VL53L1X Get Health Stats.
+ *****************************************************************************/
+void vl53l1x_app_get_health_stats(vl53l1x_app_health_stats_t *stats)
+{
+  *stats = health_stats;
+}
+
+/**************************************************************************//**
+ * VL53L1X Is Doorway Empty.
+ *****************************************************************************/
+bool vl53l1x_app_is_doorway_empty(void)
+{
+  uint8_t i;
+  uint8_t j;
+
+  // The floor calibration runs at full rate
+  if (calibrating) {
+    return false;
+  }
+  for (i = 0; i < VL53L1X_CONFIG_SENSOR_COUNT; i++) {
+    for (j = 0; j < VL53L1X_CONFIG_LANE_COUNT; j++) {
+      if (!people_counting_is_empty(&sensors[i].lanes[j])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**************************************************************************//**
+ * VL53L1X Get Activity Stats.
+ *****************************************************************************/
+void vl53l1x_app_get_activity_stats(vl53l1x_app_activity_stats_t *stats)
+{
+#if (VL53L1X_CONFIG_IDLE_PERIOD_MS > 0)
+  *stats = activity_stats;
+  if (ACTIVITY_IDLE == activity) {
+    stats->idle_time_ms += get_time_ms() - activity_ms;
+  }
+#else
+  memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Private function
+
+static sl_status_t wait_boot(uint16_t addr)
+{
+  uint8_t boot_state;
+  uint32_t waited_ms = 0;
+  sl_status_t sc;
+
+  // The sensor may not answer until it booted
+  for (;;) {
+    sc = vl53l1x_get_boot_state(addr, &boot_state);
+    if ((SL_STATUS_OK == sc) && boot_state) {
+      return SL_STATUS_OK;
+    }
+    if (waited_ms >= BOOT_TIMEOUT_MS) {
+      return SL_STATUS_TIMEOUT;
+    }
+    delay_ms(BOOT_POLL_MS);
+    waited_ms += BOOT_POLL_MS;
+  }
+}
+
+static void delay_ms(uint32_t ms)
+{
+#ifdef VL53L1X_PLATFORM_EMULATOR
+  vl53l1_emul_advance_us(ms * 1000);
+#else
+  sl_sleeptimer_delay_millisecond(ms);
+#endif
+}
+
+static void init_sensor(uint8_t index)
+{
+  uint16_t addr = sensors[index].addr;
+  sl_status_t sc;
+  uint16_t sensor_id;
+
+  sc = vl53l1x_get_sensor_id(addr, &sensor_id);
+  app_assert_status(sc);
+  log_info("VL53L1X 0x%02X Model ID: %X\r\n", addr, sensor_id);
+  log_info("VL53L1X 0x%02X booted\r\n", addr);
+
+  sc = configure_sensor(index);
+  app_assert_status(sc);
+}
+
+static sl_status_t configure_sensor(uint8_t index)
+{
+  vl53l1x_app_sensor_t *sensor = &sensors[index];
+  sl_status_t sc;
+
+  // Initialize VL53L1X
+  sc = vl53l1x_init(sensor->addr);
+
+  // Configure distance mode to LONG distance mode
+  if (SL_STATUS_OK == sc) {
+    sc = vl53l1x_set_distance_mode(sensor->addr, DISTANCE_MODE);
+  }
+
+  // Set timing budget of the current sampling rate
+  if (SL_STATUS_OK == sc) {
+    sc = set_timing_budget(sensor->addr,
+                           get_timing_budget(),
+                           get_inter_measurement());
+  }
+
+  // Set region of interest of the current zone
+  if (SL_STATUS_OK == sc) {
+    sc = set_zone(sensor->addr, sensor->zone);
+  }
+
+#if (VL53L1X_CONFIG_INT_ENABLE == 1)
+  // GPIO1 is open drain, drive it low on data ready
+  if (SL_STATUS_OK == sc) {
+    sc = vl53l1x_set_interrupt_polarity(sensor->addr, INTERRUPT_ACTIVE_LOW);
+  }
+#endif
+
+  // Calibration of the installation, none yet on first init
+  if ((SL_STATUS_OK == sc) && (calibration.flags & CALIBRATION_OFFSET)) {
+    sc = vl53l1x_set_offset(sensor->addr, calibration.offset[index]);
+  }
+  if ((SL_STATUS_OK == sc) && (calibration.flags & CALIBRATION_XTALK)) {
+    sc = vl53l1x_set_xtalk(sensor->addr, calibration.xtalk[index]);
+  }
+  return sc;
+}
+
+static sl_status_t set_timing_budget(uint16_t addr,
+                                     uint16_t timing_budget,
+                                     uint16_t inter_measurement)
 {
   sl_status_t sc;
 
   //Set timing budget
-  sc = vl53l1x_set_timing_budget_in_ms(VL53L1X_ADDR, timing_budget);
+  sc = vl53l1x_set_timing_budget_in_ms(addr, timing_budget);
   if (sc != SL_STATUS_OK) {
     log_error("Set budget timing error: %d\r\n", (int)sc);
+    return sc;
   }
 
   // Set inter-measurement
-  sc = vl53l1x_set_inter_measurement_in_ms(VL53L1X_ADDR, timing_budget);
+  sc = vl53l1x_set_inter_measurement_in_ms(addr, inter_measurement);
   if (sc != SL_STATUS_OK) {
     log_error("Set inter-measurement timing error: %d\r\n", (int)sc);
   }
+  return sc;
 }
 
-// -----------------------------------------------------------------------------
-// Private function
-static void process_people_counting_data(int16_t distance, uint8_t zone)
+static uint16_t get_timing_budget(void)
 {
-  static uint8_t path_track[] = {0,0,0,0};
-  // init this to 1 as we start from state where nobody is any of the zones
-  static uint8_t path_track_filling_size = 1;
-  static uint8_t left_previous_status = NOBODY;
-  static uint8_t right_previous_status = NOBODY;
-  static uint16_t distances[2][DISTANCES_ARRAY_SIZE];
-  static uint16_t distances_sample_count[2] = {0,0};
+#if (VL53L1X_CONFIG_IDLE_PERIOD_MS > 0)
+  if ((ACTIVITY_IDLE == activity)
+      && (VL53L1X_CONFIG_IDLE_TIMING_BUDGET_MS < timing_budget_ms)) {
+    return VL53L1X_CONFIG_IDLE_TIMING_BUDGET_MS;
+  }
+#endif
+  return timing_budget_ms;
+}
 
-  uint16_t min_distance;
-  uint8_t i;
+static uint16_t get_inter_measurement(void)
+{
+#if (VL53L1X_CONFIG_IDLE_PERIOD_MS > 0)
+  if ((ACTIVITY_IDLE == activity)
+      && (VL53L1X_CONFIG_IDLE_PERIOD_MS > get_timing_budget())) {
+    return VL53L1X_CONFIG_IDLE_PERIOD_MS;
+  }
+#endif
+  // The rangings are back to back
+  return get_timing_budget();
+}
 
-  uint8_t current_zone_status = NOBODY;
-  uint8_t all_zones_current_status = 0;
-  uint8_t an_event_has_occured = 0;
-
-  // Add just picked distance to the table of the corresponding zone
-  distances[zone][distances_sample_count[zone] % DISTANCES_ARRAY_SIZE]
-                  = distance;
-  distances_sample_count[zone]++;
-
-  // pick up the min distance
-  min_distance = distances[zone][0];
-  for (i = 1; i < DISTANCES_ARRAY_SIZE
-      && i < distances_sample_count[zone]; i++) {
-    if (distances[zone][i] < min_distance) {
-      min_distance = distances[zone][i];
-    }
+static sl_status_t set_zone(uint16_t addr, uint8_t zone)
+{
+  sl_status_t sc;
+
+  app_assert((zones[zone].width >= 4) && (zones[zone].height >= 4),
+             "Missing zone %d in VL53L1X_CONFIG_ZONES\r\n", zone);
+  // The size is only written when it differs from the previous zone
+  sc = vl53l1x_set_roi_xy(addr, zones[zone].width, zones[zone].height);
+  if (SL_STATUS_OK == sc) {
+    sc = vl53l1x_set_roi_center(addr, zones[zone].center);
   }
+  return sc;
+}
+
+static sl_status_t start_zone_scan(vl53l1x_app_sensor_t *sensor)
+{
+  sl_status_t sc;
 
-  if (min_distance < vl53l1x_distance_threshold) {
-    // Someone is in !
-    current_zone_status = SOMEONE;
+  // Give the sensor the time of a ranging before it is found silent
+  sensor->result_ms = get_time_ms();
+  sc = set_zone(sensor->addr, sensor->zone);
+  if (SL_STATUS_OK == sc) {
+    sc = vl53l1x_start_ranging(sensor->addr);
+  }
+#if (ZONE_LOOKAHEAD > 1)
+  // The ranging just started has latched the current zone already
+  if (SL_STATUS_OK == sc) {
+    sc = set_zone(sensor->addr, (sensor->zone + 1) % ZONE_COUNT);
   }
+#endif
+  return sc;
+}
 
-  if (zone == LEFT) {
-    if (current_zone_status != left_previous_status) {
-      // event in left zone has occured
-      an_event_has_occured = 1;
+#if (VL53L1X_CONFIG_SENSOR_COUNT > 1)
+static void set_xshut(uint8_t index, bool enable)
+{
+#ifdef VL53L1X_PLATFORM_EMULATOR
+  vl53l1_emul_set_xshut(index, enable);
+#else
+  static const GPIO_Port_TypeDef xshut_port[VL53L1X_CONFIG_SENSOR_COUNT] =
+    VL53L1X_CONFIG_XSHUT_PORTS;
+  static const uint8_t xshut_pin[VL53L1X_CONFIG_SENSOR_COUNT] =
+    VL53L1X_CONFIG_XSHUT_PINS;
 
-      if (current_zone_status == SOMEONE) {
-        all_zones_current_status += 1;
-      }
-      // need to check right zone as well ...
-      if (right_previous_status == SOMEONE) {
-        // event in left zone has occured
-        all_zones_current_status += 2;
+  // XSHUT is active low
+  GPIO_PinModeSet(xshut_port[index],
+                  xshut_pin[index],
+                  gpioModePushPull,
+                  enable ? 1 : 0);
+#endif
+}
+
+static void switch_active_sensor(void)
+{
+  sl_status_t sc;
+
+  // The interrupt is cleared, stop the ranging which has just started
+  sc = vl53l1x_stop_ranging(sensors[active_sensor].addr);
+  if (SL_STATUS_OK != sc) {
+    log_error("Error in stopping ranging: 0x%x\r\n", sc);
+  }
+  active_sensor = (active_sensor + 1) % VL53L1X_CONFIG_SENSOR_COUNT;
+  sc = start_zone_scan(&sensors[active_sensor]);
+  if (SL_STATUS_OK != sc) {
+    log_error("Error in starting ranging: 0x%x\r\n", sc);
+  }
+}
+#endif
+#if (VL53L1X_CONFIG_INT_ENABLE == 1)
+static void data_ready_interrupt_callback(uint8_t int_no)
+{
+  (void) int_no;
+  // Start the readout right away, the bus arbiter runs it between two
+  // display transfers at the latest
+  if (SL_STATUS_OK != start_result_read()) {
+    // Retry from the application context
+    vl53l1x_app_on_data_ready();
+  }
+}
+#endif
+
+static sl_status_t start_result_read(void)
+{
+  sl_status_t sc;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  if (RESULT_READ_IDLE != result_read_state) {
+    // Already on the bus or waiting to be processed
+    CORE_EXIT_ATOMIC();
+    return SL_STATUS_OK;
+  }
+  result_read_state = RESULT_READ_PENDING;
+  CORE_EXIT_ATOMIC();
+
+  // Read the result block and re-arm the interrupt in the background
+  sc = vl53l1x_get_result_and_clear_interrupt_async(sensors[active_sensor].addr,
+                                                    &result_request,
+                                                    result_read_callback,
+                                                    NULL);
+  if (SL_STATUS_OK != sc) {
+    result_read_state = RESULT_READ_IDLE;
+  }
+
+  return sc;
+}
+
+static void result_read_callback(sl_status_t status,
+                                 const vl53l1x_result_t *result,
+                                 void *context)
+{
+  (void) result;
+  (void) context;
+  result_read_status = status;
+  result_read_state = RESULT_READ_DONE;
+  // Let the result be processed in the application context
+  vl53l1x_app_on_data_ready();
+}
+
+static void process_result(vl53l1x_app_sensor_t *sensor,
+                           const vl53l1x_result_t *result)
+{
+  uint8_t range_status = result->status;
+  uint16_t distance = result->distance;
+  people_counting_sample_t sample;
+  people_counting_event_t event;
+  bool failure = false;
+  uint8_t lane;
+  sl_status_t sc;
+
+#if (IDLE_THRESHOLD_WAKE == 1)
+  if (ACTIVITY_IDLE == activity) {
+    // Only a ranging below the threshold is signaled while idle, it covers
+    // all the zones and is not counted
+    wake_up(true);
+    return;
+  }
+#endif
+
+  measured_distance = distance;
+  sample.valid = true;
+
+  switch (range_status) {
+    case 0:  // VL53L1_RANGESTATUS_RANGE_VALID Ranging measurement is valid
+    case 4:  // VL53L1_RANGESTATUS_OUTOFBOUNDS_ FAIL Raised when phase
+             // is out of bounds
+    case 7:  // VL53L1_RANGESTATUS_WRAP_TARGET_ FAIL Wrapped target,
+             // not matching phases
+      // wraparound case see the explanation at the constants definition place
+      if (distance <= vl53l1x_min_distance)
+        distance = vl53l1x_max_distance + vl53l1x_min_distance;
+      break;
+    case 1:  // VL53L1_RANGESTATUS_SIGMA_FAIL Raised if sigma estimator check
+             // is above the internal defined threshold
+    case 2:  // VL53L1_RANGESTATUS_SIGNAL_FAIL Raised if signal value
+             // is below the internal defined threshold
+    case 14: // VL53L1_RANGESTATUS_RANGE_INVALID The reported range is invalid
+      distance = vl53l1x_max_distance;
+      sample.valid = false;
+      invalid_count++;
+      break;
+    case 5:  // VL53L1_RANGESTATUS_HARDWARE_FAIL Raised in case
+             // of HW or VCSEL failure
+    case 8:  // VL53L1_RANGESTATUS_PROCESSING_FAIL
+             // Internal algorithm underflow or overflow
+      distance = vl53l1x_max_distance;
+      sample.valid = false;
+      invalid_count++;
+      failure = true;
+      break;
+    case 13: // The 13 simply means the hardware was not able to select
+             // that particular ROI with that specific center location.
+             // This situation happens a lot when moving the ROI
+             // as close to the edge
+             // as possible. To avoid it, reduce the X or Y
+             // dimensions or move the ROI_Center one SPAD toward the middle.
+             // A sensor which keeps reporting it is failed, see UM2555.
+      distance = vl53l1x_max_distance;
+      sample.valid = false;
+      failure = true;
+      break;
+    default:
+      log_error("Unknown range status: %d\r\n", range_status);
+      distance = vl53l1x_max_distance;
+      sample.valid = false;
+      failure = true;
+      break;
+  }
+  update_zone_health(sensor, result, failure);
+  if (calibrating) {
+    // The doorway is empty, the sample is the floor of the zone
+    add_floor_sample(sensor - sensors, sensor->zone, distance);
+  } else {
+    // The result block holds the rates of all the SPADs of the ROI
+    sample.distance = distance;
+    sample.signal_per_spad = result->number_per_spads
+                             ? result->signal_per_spad
+                               / result->number_per_spads
+                             : 0;
+    sample.ambient_per_spad = result->number_per_spads
+                              ? result->ambient / result->number_per_spads
+                              : 0;
+    // add new ranging sample to the people counting of the lane,
+    // the lanes count independently so people side by side are all counted
+    lane = sensor->zone / PEOPLE_COUNTING_ZONES;
+    event = people_counting_process(&sensor->lanes[lane],
+                                    &sample,
+                                    sensor->zone % PEOPLE_COUNTING_ZONES);
+    dispatch_event(sensor - sensors, event);
+#if (VL53L1X_CONFIG_TRACE_SIZE > 0)
+    add_trace_record(sensor - sensors, sensor->zone, range_status, &sample);
+#endif
+  }
+
+  sensor->zone++;
+  sensor->zone %= ZONE_COUNT;
+
+  // Zone of the ranging after the ones already started
+  sc = set_zone(sensor->addr,
+                (sensor->zone + ZONE_LOOKAHEAD - 1) % ZONE_COUNT);
+  if (SL_STATUS_OK != sc) {
+    log_error("Error in changing ROI: 0x%x\r\n", sc);
+  }
+#if (VL53L1X_CONFIG_IDLE_PERIOD_MS > 0)
+  update_activity();
+#endif
+}
+
+static void dispatch_event(uint8_t index, people_counting_event_t event)
+{
+#if (VL53L1X_CONFIG_SENSOR_COUNT > 1) && (VL53L1X_CONFIG_MERGE_WINDOW_MS > 0)
+  static uint32_t last_tick[PEOPLE_COUNTING_EVENT_LEAVE + 1];
+  static uint8_t last_sensor[PEOPLE_COUNTING_EVENT_LEAVE + 1] = {
+    NO_SENSOR, NO_SENSOR, NO_SENSOR
+  };
+  uint32_t now = sl_sleeptimer_get_tick_count();
+
+  if (PEOPLE_COUNTING_EVENT_NONE == event) {
+    return;
+  }
+  // Someone seen by two sensors of the same doorway is counted once
+  if ((NO_SENSOR != last_sensor[event])
+      && (index != last_sensor[event])
+      && ((now - last_tick[event])
+          < sl_sleeptimer_ms_to_tick(VL53L1X_CONFIG_MERGE_WINDOW_MS))) {
+    log_info("Sensor %d event merged\r\n", index);
+    last_sensor[event] = NO_SENSOR;
+    return;
+  }
+  last_tick[event] = now;
+  last_sensor[event] = index;
+#else
+  (void) index;
+#endif
+
+  switch (event) {
+    case PEOPLE_COUNTING_EVENT_ENTER:
+      vl53l1x_app_on_event(VL53L1X_APP_EVENT_SOMEONE_ENTER);
+      break;
+    case PEOPLE_COUNTING_EVENT_LEAVE:
+      vl53l1x_app_on_event(VL53L1X_APP_EVENT_SOMEONE_LEAVE);
+      break;
+    default:
+      break;
+  }
+}
+
+static void add_floor_sample(uint8_t index, uint8_t zone, uint16_t distance)
+{
+  uint8_t i;
+  uint8_t j;
+
+  if (floor_sample_count[index][zone] < CALIBRATION_SAMPLES) {
+    floor_samples[index][zone][floor_sample_count[index][zone]++] = distance;
+  }
+  // Wait for all the zones of all the sensors
+  for (i = 0; i < VL53L1X_CONFIG_SENSOR_COUNT; i++) {
+    for (j = 0; j < ZONE_COUNT; j++) {
+      if (floor_sample_count[i][j] < CALIBRATION_SAMPLES) {
+        return;
       }
-      // store current zone status
-      left_previous_status = current_zone_status;
     }
   }
-  else {
+  finish_calibration();
+}
 
-    if (current_zone_status != right_previous_status) {
+static void finish_calibration(void)
+{
+  sl_status_t sc;
+  uint16_t floor_distance;
+  uint8_t i;
+  uint8_t j;
 
-      // event in left zone has occured
-      an_event_has_occured = 1;
-      if (current_zone_status == SOMEONE) {
-        all_zones_current_status += 2;
-      }
-      // need to left right zone as well ...
-      if (left_previous_status == SOMEONE) {
-        // event in left zone has occured
-        all_zones_current_status += 1;
+  for (i = 0; i < VL53L1X_CONFIG_SENSOR_COUNT; i++) {
+    for (j = 0; j < ZONE_COUNT; j++) {
+      // The median ignores people walking through during the calibration
+      floor_distance = get_median(floor_samples[i][j], CALIBRATION_SAMPLES);
+      if (floor_distance > vl53l1x_max_distance) {
+        floor_distance = vl53l1x_max_distance;
       }
-      // store current zone status
-      right_previous_status = current_zone_status;
+      calibration.threshold[i][j] =
+        (uint32_t)floor_distance * CALIBRATION_THRESHOLD_PCT / 100;
+      log_info("Sensor %d zone %d: floor %d mm, threshold %d mm\r\n",
+               i, j, floor_distance, calibration.threshold[i][j]);
+    }
+    // Restart the counting from an empty doorway
+    for (j = 0; j < VL53L1X_CONFIG_LANE_COUNT; j++) {
+      people_counting_init(&sensors[i].lanes[j], 0);
+    }
+    apply_thresholds(i);
+  }
+  calibration.version = CALIBRATION_VERSION;
+  calibrating = false;
+  calibrated = true;
+
+  sc = store_calibration();
+  if (SL_STATUS_OK != sc) {
+    log_error("Calibration storage error: 0x%x\r\n", sc);
+  }
+  vl53l1x_app_on_event(VL53L1X_APP_EVENT_CALIBRATED);
+}
+
+static uint16_t get_median(uint16_t *samples, uint8_t count)
+{
+  uint16_t sample;
+  uint8_t i;
+  uint8_t j;
+
+  // Insertion sort, the samples are not used afterwards
+  for (i = 1; i < count; i++) {
+    sample = samples[i];
+    for (j = i; (j > 0) && (samples[j - 1] > sample); j--) {
+      samples[j] = samples[j - 1];
+    }
+    samples[j] = sample;
+  }
+  return samples[count / 2];
+}
+
+static void apply_thresholds(uint8_t index)
+{
+  uint8_t zone;
+
+  for (zone = 0; zone < ZONE_COUNT; zone++) {
+    people_counting_set_threshold(
+      &sensors[index].lanes[zone / PEOPLE_COUNTING_ZONES],
+      zone % PEOPLE_COUNTING_ZONES,
+      calibration.threshold[index][zone]);
+  }
+}
+
+static sl_status_t load_calibration(void)
+{
+#ifdef VL53L1X_PLATFORM_EMULATOR
+  // Host builds keep the calibration in RAM
+  return SL_STATUS_NOT_FOUND;
+#else
+  uint32_t type;
+  size_t len;
+  Ecode_t ec;
+
+  // A calibration of another sensor or zone layout has another size
+  ec = nvm3_getObjectInfo(nvm3_defaultHandle,
+                          VL53L1X_CONFIG_NVM3_CALIBRATION_KEY,
+                          &type,
+                          &len);
+  if ((ECODE_NVM3_OK != ec)
+      || (NVM3_OBJECTTYPE_DATA != type)
+      || (sizeof(calibration) != len)) {
+    return SL_STATUS_NOT_FOUND;
+  }
+  ec = nvm3_readData(nvm3_defaultHandle,
+                     VL53L1X_CONFIG_NVM3_CALIBRATION_KEY,
+                     &calibration,
+                     sizeof(calibration));
+  if ((ECODE_NVM3_OK != ec) || (CALIBRATION_VERSION != calibration.version)) {
+    memset(&calibration, 0, sizeof(calibration));
+    return SL_STATUS_NOT_FOUND;
+  }
+  return SL_STATUS_OK;
+#endif
+}
+
+static sl_status_t store_calibration(void)
+{
+#ifdef VL53L1X_PLATFORM_EMULATOR
+  return SL_STATUS_OK;
+#else
+  Ecode_t ec;
+
+  ec = nvm3_writeData(nvm3_defaultHandle,
+                      VL53L1X_CONFIG_NVM3_CALIBRATION_KEY,
+                      &calibration,
+                      sizeof(calibration));
+  if (ECODE_NVM3_OK != ec) {
+    return SL_STATUS_FLASH_PROGRAM_FAILED;
+  }
+  return SL_STATUS_OK;
+#endif
+}
+
+#if (VL53L1X_CONFIG_TRACE_SIZE > 0)
+static void add_trace_record(uint8_t index,
+                             uint8_t zone,
+                             uint8_t status,
+                             const people_counting_sample_t *sample)
+{
+  people_counting_trace_record_t record;
+
+  record.time_ms = get_time_ms();
+  record.zone = index * ZONE_COUNT + zone;
+  record.status = status;
+  record.sample = *sample;
+  people_counting_trace_add(&trace, &record);
+}
+#endif
+
+#if (VL53L1X_CONFIG_IDLE_PERIOD_MS > 0)
+static void update_activity(void)
+{
+  uint32_t now = get_time_ms();
+  bool empty = vl53l1x_app_is_doorway_empty();
+
+  if (ACTIVITY_IDLE == activity) {
+    if (!empty) {
+      // Someone may be walking through, back to full rate right away
+      wake_up(true);
     }
+    return;
   }
 
-  // if an event has occured
-  if (an_event_has_occured) {
-    if (path_track_filling_size < 4) {
-      path_track_filling_size ++;
+  if (wake_pending) {
+    // First sample ranged at full rate
+    wake_pending = false;
+    activity_stats.wake_latency_ms = now - wake_ms;
+    if (activity_stats.wake_latency_ms > activity_stats.wake_latency_max_ms) {
+      activity_stats.wake_latency_max_ms = activity_stats.wake_latency_ms;
     }
+    log_info("Full rate after %lu ms\r\n",
+             (unsigned long)activity_stats.wake_latency_ms);
+  }
+  if (!empty) {
+    activity_ms = now;
+  } else if ((now - activity_ms) >= VL53L1X_CONFIG_IDLE_DELAY_MS) {
+    activity_stats.idle_count++;
+    activity_ms = now;
+    set_activity(ACTIVITY_IDLE);
+  }
+}
+
+static void wake_up(bool measured)
+{
+  uint32_t now = get_time_ms();
+
+  activity_stats.idle_time_ms += now - activity_ms;
+  activity_ms = now;
+  if (measured) {
+    wake_ms = now;
+    wake_pending = true;
+  }
+  set_activity(ACTIVITY_ACTIVE);
+}
 
-    // if nobody anywhere lets check if an exit or entry has happened
-    if ((left_previous_status == NOBODY) && (right_previous_status == NOBODY)) {
-
-      // check exit or entry only if path_track_filling_size
-      // is 4 (for example 0 1 3 2) and last event is 0 (nobobdy anywhere)
-      if (path_track_filling_size == 4) {
-        // check exit or entry. no need to check path_track[0] == 0 ,
-        // it is always the case
-
-        if ((path_track[1] == 1)
-            && (path_track[2] == 3)
-            && (path_track[3] == 2)) {
-          // People enter the room
-          vl53l1x_app_on_event(VL53L1X_APP_EVENT_SOMEONE_ENTER);
-
-          // reset the table filling size in case an entry or exit just found
-          distances_sample_count[0] = 0;
-          distances_sample_count[1] = 0;
-
-        }
-        else if ((path_track[1] == 2)
-                   && (path_track[2] == 3)
-                   && (path_track[3] == 1)) {
-          // People exit the room
-          vl53l1x_app_on_event(VL53L1X_APP_EVENT_SOMEONE_LEAVE);
-
-          // reset the table filling size in case an entry or exit just found
-          distances_sample_count[0] = 0;
-          distances_sample_count[1] = 0;
-        }
-        else {
-          // reset the table filling size also in case of unexpected path
-          distances_sample_count[0] = 0;
-          distances_sample_count[1] = 0;
-          log_info("Invalid path\r\n");
-        }
+static void set_activity(uint8_t next)
+{
+  uint16_t inter_measurement;
+  sl_status_t sc;
+  uint8_t i;
+
+  activity = next;
+  inter_measurement = get_inter_measurement();
+
+  // The budget and period are applied on start of ranging, restart the
+  // current zone. The full rate budget is restored on wake up.
+  sc = vl53l1x_stop_ranging(sensors[active_sensor].addr);
+  for (i = 0; i < VL53L1X_CONFIG_SENSOR_COUNT; i++) {
+    set_timing_budget(sensors[i].addr, get_timing_budget(), inter_measurement);
+  }
+#if (IDLE_THRESHOLD_WAKE == 1)
+  if ((SL_STATUS_OK == sc) && (ACTIVITY_IDLE == next)) {
+    sc = start_threshold_wake(&sensors[active_sensor]);
+  } else if (SL_STATUS_OK == sc) {
+    sc = vl53l1x_clear_distance_threshold(sensors[active_sensor].addr);
+  }
+  if ((SL_STATUS_OK == sc) && (ACTIVITY_ACTIVE == next)) {
+    sc = start_zone_scan(&sensors[active_sensor]);
+  }
+#else
+  if (SL_STATUS_OK == sc) {
+    sc = start_zone_scan(&sensors[active_sensor]);
+  }
+#endif
+  if (SL_STATUS_OK != sc) {
+    log_error("Error in changing the sampling rate: 0x%x\r\n", sc);
+  }
+}
+#endif
+
+#if (IDLE_THRESHOLD_WAKE == 1)
+static sl_status_t start_threshold_wake(vl53l1x_app_sensor_t *sensor)
+{
+  uint16_t threshold = UINT16_MAX;
+  sl_status_t sc;
+  uint8_t j;
+  uint8_t z;
+
+  // Someone entering any zone is closer than the lowest threshold
+  for (j = 0; j < VL53L1X_CONFIG_LANE_COUNT; j++) {
+    for (z = 0; z < PEOPLE_COUNTING_ZONES; z++) {
+      if (sensor->lanes[j].distance_threshold[z] < threshold) {
+        threshold = sensor->lanes[j].distance_threshold[z];
       }
+    }
+  }
+  sc = vl53l1x_set_roi_xy(sensor->addr, FULL_ROI_SIZE, FULL_ROI_SIZE);
+  if (SL_STATUS_OK == sc) {
+    sc = vl53l1x_set_roi_center(sensor->addr, FULL_ROI_CENTER);
+  }
+  if (SL_STATUS_OK == sc) {
+    sc = vl53l1x_set_distance_threshold(sensor->addr,
+                                        threshold,
+                                        threshold,
+                                        THRESHOLD_WINDOW_BELOW);
+  }
+  if (SL_STATUS_OK == sc) {
+    sc = vl53l1x_start_ranging(sensor->addr);
+  }
+  return sc;
+}
+#endif
+
+static void update_zone_health(vl53l1x_app_sensor_t *sensor,
+                               const vl53l1x_result_t *result,
+                               bool failure)
+{
+  vl53l1x_app_zone_health_t *zone = &sensor->zone_health[sensor->zone];
+  uint32_t now = get_time_ms();
+
+  // Rate of the hardware failures over a window of rangings
+  zone->rangings++;
+  if (failure) {
+    zone->failures++;
+  }
+  if (zone->rangings >= HEALTH_WINDOW) {
+    if (zone->failures * 100 >= HEALTH_FAILURE_PCT * HEALTH_WINDOW) {
+      sensor->fault = HEALTH_FAULT_FAILURES;
+    }
+    zone->rangings = 0;
+    zone->failures = 0;
+  }
+
+  // A target always brings some noise on the distance and the signal
+  if ((0 != result->status) || !result->signal_per_spad) {
+    zone->changed_ms = now;
+    return;
+  }
+  if ((result->distance != zone->distance)
+      || (result->signal_per_spad != zone->signal)) {
+    zone->distance = result->distance;
+    zone->signal = result->signal_per_spad;
+    zone->changed_ms = now;
+  } else if ((now - zone->changed_ms) >= HEALTH_STUCK_MS) {
+    sensor->fault = HEALTH_FAULT_STUCK;
+  }
+}
 
-      path_track_filling_size = 1;
+static void add_bus_error(vl53l1x_app_sensor_t *sensor)
+{
+  if (sensor->bus_errors < UINT8_MAX) {
+    sensor->bus_errors++;
+  }
+  if (sensor->bus_errors >= HEALTH_BUS_ERRORS) {
+    sensor->fault = HEALTH_FAULT_BUS;
+  }
+}
+
+static void handle_fault(vl53l1x_app_sensor_t *sensor)
+{
+  if (HEALTH_FAULT_NONE == sensor->fault) {
+    return;
+  }
+  // Give the previous recovery some time, a failed sensor even more
+  if ((get_time_ms() - sensor->recovery_ms) >= get_recovery_delay(sensor)) {
+    recover_sensor(sensor);
+  }
+}
+
+static uint32_t get_recovery_delay(const vl53l1x_app_sensor_t *sensor)
+{
+  if (0 == sensor->recoveries) {
+    return 0;
+  }
+  if (sensor->recoveries >= HEALTH_RECOVERY_MAX) {
+    return HEALTH_RETRY_MS;
+  }
+  return HEALTH_BACKOFF_MS << (sensor->recoveries - 1);
+}
+
+static void recover_sensor(vl53l1x_app_sensor_t *sensor)
+{
+  uint8_t index = sensor - sensors;
+  // Configure the sensor again first, reset it if that was not enough
+  bool reset = (sensor->recoveries > 0);
+  sl_status_t sc = SL_STATUS_OK;
+
+  switch (sensor->fault) {
+    case HEALTH_FAULT_BUS:
+      health_stats.bus_errors++;
+      break;
+    case HEALTH_FAULT_FAILURES:
+      health_stats.failure_rates++;
+      break;
+    case HEALTH_FAULT_STUCK:
+      health_stats.stuck++;
+      break;
+    default:
+      health_stats.silences++;
+      break;
+  }
+  log_error("Sensor %d fault %d, recovery %d\r\n",
+            index, sensor->fault, sensor->recoveries);
+  sensor->fault = HEALTH_FAULT_NONE;
+  sensor->bus_errors = 0;
+  memset(sensor->zone_health, 0, sizeof(sensor->zone_health));
+  if (sensor->recoveries < HEALTH_RECOVERY_MAX) {
+    sensor->recoveries++;
+  }
+  sensor->recovery_ms = get_time_ms();
+  // Wait for a result again even if the sensor does not start
+  sensor->result_ms = sensor->recovery_ms;
+
+  if (index == active_sensor) {
+    (void) vl53l1x_stop_ranging(sensor->addr);
+  }
+  if (reset) {
+    health_stats.resets++;
+    sc = reset_sensor(index);
+  } else {
+    health_stats.reconfigures++;
+  }
+  if (SL_STATUS_OK == sc) {
+    sc = configure_sensor(index);
+  }
+  if ((SL_STATUS_OK == sc) && (index == active_sensor)) {
+#if (IDLE_THRESHOLD_WAKE == 1)
+    if (ACTIVITY_IDLE == activity) {
+      sc = start_threshold_wake(sensor);
+    } else {
+      sc = start_zone_scan(sensor);
     }
-    else {
-      // update path_track
-      // example of path_track update
-      // 0
-      // 0 1
-      // 0 1 3
-      // 0 1 3 1
-      // 0 1 3 3
-      // 0 1 3 2 ==> if next is 0 : check if exit
-      path_track[path_track_filling_size-1] = all_zones_current_status;
+#else
+    sc = start_zone_scan(sensor);
+#endif
+  }
+  if (SL_STATUS_OK != sc) {
+    log_error("Sensor %d recovery error: 0x%x\r\n", index, sc);
+  }
+  update_health();
+}
+
+static sl_status_t reset_sensor(uint8_t index)
+{
+  uint16_t addr = sensors[index].addr;
+  sl_status_t sc;
+
+#if (VL53L1X_CONFIG_SENSOR_COUNT > 1)
+  // Power cycle through XSHUT, the other sensors keep their address
+  set_xshut(index, false);
+  delay_ms(XSHUT_LOW_MS);
+  set_xshut(index, true);
+#else
+  sc = vl53l1x_software_reset(addr);
+  if (SL_STATUS_OK != sc) {
+    return sc;
+  }
+#endif
+  // The sensor boots at the default address
+  sc = wait_boot(VL53L1X_ADDR);
+  if ((SL_STATUS_OK == sc) && (addr != VL53L1X_ADDR)) {
+    sc = vl53l1x_set_i2c_address(VL53L1X_ADDR, addr << 1);
+  }
+  return sc;
+}
+
+static void update_health(void)
+{
+  vl53l1x_app_health_t next = VL53L1X_APP_HEALTH_OK;
+  uint8_t i;
+
+  for (i = 0; i < VL53L1X_CONFIG_SENSOR_COUNT; i++) {
+    if (sensors[i].recoveries >= HEALTH_RECOVERY_MAX) {
+      next = VL53L1X_APP_HEALTH_FAILED;
+    } else if (sensors[i].recoveries && (VL53L1X_APP_HEALTH_OK == next)) {
+      next = VL53L1X_APP_HEALTH_RECOVERING;
     }
   }
+  if (next != health) {
+    health = next;
+    vl53l1x_app_on_event(VL53L1X_APP_EVENT_HEALTH_CHANGED);
+  }
+}
+
+static uint32_t get_time_ms(void)
+{
+#ifdef VL53L1X_PLATFORM_EMULATOR
+  return (uint32_t)(vl53l1_emul_get_time_us() / 1000);
+#else
+  uint64_t time_ms;
+
+  sl_sleeptimer_tick64_to_ms(sl_sleeptimer_get_tick_count64(), &time_ms);
+  return (uint32_t)time_ms;
+#endif
 }
 
 /** @} (end group vl53l1x_app) */
@@ -208,7 +208,8 @@ VL53L1X_ERROR VL53L1X_SensorInit(uint16_t dev)
 	}
 	status |= VL53L1X_StartRanging(dev);
 	tmp  = 0;
-	while(tmp==0){
+	/* give up when the device does not answer instead of polling forever */
+	while((tmp==0) && (status==0)){
 			status |= VL53L1X_CheckForDataReady(dev, &tmp);
 	}
 	status |= VL53L1X_ClearInterrupt(dev);
@@ -602,19 +603,35 @@ VL53L1X_ERROR VL53L1X_GetRangeStatus(uint16_t dev, uint8_t *rangeStatus)
 VL53L1X_ERROR VL53L1X_GetResult(uint16_t dev, VL53L1X_Result_t *pResult)
 {
 	VL53L1X_ERROR status = 0;
-	uint8_t Temp[17];
+	uint8_t Temp[VL53L1_RESULT__BLOCK_SIZE];
+
+	status |= VL53L1_ReadMulti(dev, VL53L1_RESULT__RANGE_STATUS, Temp,
+			VL53L1_RESULT__BLOCK_SIZE);
+	VL53L1X_DecodeResult(Temp, pResult);
+
+	return status;
+}
+
+void VL53L1X_DecodeResult(const uint8_t *pRaw, VL53L1X_Result_t *pResult)
+{
 	uint8_t RgSt = 255;
 
-	status |= VL53L1_ReadMulti(dev, VL53L1_RESULT__RANGE_STATUS, Temp, 17);
-	RgSt = Temp[0] & 0x1F;
+	RgSt = pRaw[0] & 0x1F;
 	if (RgSt < 24)
 		RgSt = status_rtn[RgSt];
 	pResult->Status = RgSt;
-	pResult->Ambient = (Temp[7] << 8 | Temp[8]) * 8;
-	pResult->NumSPADs = Temp[3];
-	pResult->SigPerSPAD = (Temp[15] << 8 | Temp[16]) * 8;
-	pResult->Distance = Temp[13] << 8 | Temp[14];
+	pResult->Ambient = (pRaw[7] << 8 | pRaw[8]) * 8;
+	pResult->NumSPADs = pRaw[3];
+	pResult->SigPerSPAD = (pRaw[15] << 8 | pRaw[16]) * 8;
+	pResult->Distance = pRaw[13] << 8 | pRaw[14];
+}
 
+VL53L1X_ERROR VL53L1X_GetResultAndClearInterrupt(uint16_t dev, VL53L1X_Result_t *pResult)
+{
+	VL53L1X_ERROR status = 0;
+
+	status |= VL53L1X_GetResult(dev, pResult);
+	status |= VL53L1_WrByte(dev, SYSTEM__INTERRUPT_CLEAR, 0x01);
 	return status;
 }
 
@@ -813,7 +830,7 @@ VL53L1X_ERROR VL53L1X_StartTemperatureUpdate(uint16_t dev)
 	status |= VL53L1_WrByte(dev,VL53L1_VHV_CONFIG__TIMEOUT_MACROP_LOOP_BOUND,0x81); /* full VHV */
 	status |= VL53L1_WrByte(dev,0x0B,0x92);
 	status |= VL53L1X_StartRanging(dev);
-	while(tmp==0){
+	while((tmp==0) && (status==0)){
 		status |= VL53L1X_CheckForDataReady(dev, &tmp);
 	}
 	tmp  = 0;
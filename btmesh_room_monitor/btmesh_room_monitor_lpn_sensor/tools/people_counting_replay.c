@@ -0,0 +1,207 @@
+/***************************************************************************//**
+ * @file people_counting_replay.c
+ * @brief Offline replay of a people counting trace
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "people_counting.h"
+
+/***************************************************************************//**
+ * @addtogroup people_counting_replay
+ * @brief  People counting trace replay.
+ * @details
+ *   Host program feeding the samples printed by vl53l1x_app_dump_trace()
+ *   through people_counting.c, built with the same tuning defines as the
+ *   firmware or with the ones under test:
+ *
+ *     gcc -Iinc tools/people_counting_replay.c src/people_counting.c
+ *         -o people_counting_replay
+ *     ./people_counting_replay [-t threshold_mm] capture.log
+ *
+ *   Lines without a trace record, like the other logs of the capture, are
+ *   skipped. The zone thresholds of the capture are used unless -t is given.
+ *   The filters start empty while the firmware had the samples before the
+ *   oldest record, and the sensors are counted apart, without the merge of
+ *   the events seen by two sensors.
+ * @{
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+// Defines
+
+#define SENSOR_MAX                16
+#define LANE_MAX                  8
+#define DISTANCE_THRESHOLD        1600 // default of room_monitor_app.c
+#define LINE_SIZE                 256
+
+// -----------------------------------------------------------------------------
+// Private variables
+
+static people_counting_t lanes[SENSOR_MAX][LANE_MAX];
+static unsigned long enters[SENSOR_MAX];
+static unsigned long leaves[SENSOR_MAX];
+static unsigned long samples;
+
+// -----------------------------------------------------------------------------
+// Private function declarations
+
+static void replay_line(const char *line, int override_threshold);
+static void print_summary(void);
+
+// -----------------------------------------------------------------------------
+// Public function definitions
+
+int main(int argc, char *argv[])
+{
+  char line[LINE_SIZE];
+  FILE *file;
+  int threshold = DISTANCE_THRESHOLD;
+  int override_threshold = 0;
+  int arg = 1;
+  int i;
+  int j;
+
+  if ((argc > 2) && (0 == strcmp(argv[1], "-t"))) {
+    threshold = atoi(argv[2]);
+    override_threshold = 1;
+    arg = 3;
+  }
+  if ((arg != argc - 1) || (threshold <= 0)) {
+    fprintf(stderr, "usage: %s [-t threshold_mm] capture.log\n", argv[0]);
+    return 1;
+  }
+  file = fopen(argv[arg], "r");
+  if (NULL == file) {
+    perror(argv[arg]);
+    return 1;
+  }
+
+  for (i = 0; i < SENSOR_MAX; i++) {
+    for (j = 0; j < LANE_MAX; j++) {
+      people_counting_init(&lanes[i][j], (uint16_t)threshold);
+    }
+  }
+  while (fgets(line, sizeof(line), file)) {
+    replay_line(line, override_threshold);
+  }
+  fclose(file);
+
+  print_summary();
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Private function
+
+static void replay_line(const char *line, int override_threshold)
+{
+  people_counting_sample_t sample;
+  people_counting_event_t event;
+  const char *record;
+  unsigned long time_ms;
+  unsigned int sensor, lane, zone, valid, threshold;
+  unsigned int distance, signal, ambient;
+
+  record = strstr(line, "threshold,");
+  if (NULL != record) {
+    // threshold,sensor,lane,zone,mm
+    if ((4 == sscanf(record, "threshold,%u,%u,%u,%u",
+                     &sensor, &lane, &zone, &threshold))
+        && (sensor < SENSOR_MAX) && (lane < LANE_MAX)
+        && (zone < PEOPLE_COUNTING_ZONES) && !override_threshold) {
+      people_counting_set_threshold(&lanes[sensor][lane],
+                                    (uint8_t)zone,
+                                    (uint16_t)threshold);
+    }
+    return;
+  }
+
+  record = strstr(line, "trace,");
+  // trace,ms,sensor,lane,zone,status,valid,distance,signal,ambient
+  if ((NULL == record)
+      || (8 != sscanf(record, "trace,%lu,%u,%u,%u,%*u,%u,%u,%u,%u",
+                      &time_ms, &sensor, &lane, &zone, &valid,
+                      &distance, &signal, &ambient))
+      || (sensor >= SENSOR_MAX) || (lane >= LANE_MAX)
+      || (zone >= PEOPLE_COUNTING_ZONES)) {
+    return;
+  }
+  sample.distance = (uint16_t)distance;
+  sample.signal_per_spad = (uint16_t)signal;
+  sample.ambient_per_spad = (uint16_t)ambient;
+  sample.valid = (0 != valid);
+  samples++;
+
+  event = people_counting_process(&lanes[sensor][lane],
+                                  &sample,
+                                  (uint8_t)zone);
+  switch (event) {
+    case PEOPLE_COUNTING_EVENT_ENTER:
+      enters[sensor]++;
+      printf("%lu ms: sensor %u lane %u enter\n", time_ms, sensor, lane);
+      break;
+    case PEOPLE_COUNTING_EVENT_LEAVE:
+      leaves[sensor]++;
+      printf("%lu ms: sensor %u lane %u leave\n", time_ms, sensor, lane);
+      break;
+    default:
+      break;
+  }
+}
+
+static void print_summary(void)
+{
+  unsigned long rejects[PEOPLE_COUNTING_REJECT_COUNT] = { 0 };
+  int i;
+  int j;
+  int r;
+
+  printf("%lu samples\n", samples);
+  for (i = 0; i < SENSOR_MAX; i++) {
+    if (enters[i] || leaves[i]) {
+      printf("sensor %d: %lu in, %lu out\n", i, enters[i], leaves[i]);
+    }
+    for (j = 0; j < LANE_MAX; j++) {
+      for (r = 0; r < PEOPLE_COUNTING_REJECT_COUNT; r++) {
+        rejects[r] += lanes[i][j].rejects[r];
+      }
+    }
+  }
+  printf("paths rejected: %lu turned back, %lu ambiguous\n",
+         rejects[PEOPLE_COUNTING_REJECT_TURNED_BACK],
+         rejects[PEOPLE_COUNTING_REJECT_AMBIGUOUS]);
+}
+
+/** @} (end group people_counting_replay) */
@@ -0,0 +1,12 @@
+/*
+ * Host stand-in of the emlib em_common.h.
+ */
+#ifndef EM_COMMON_H
+#define EM_COMMON_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SL_WEAK __attribute__((weak))
+
+#endif // EM_COMMON_H
@@ -0,0 +1,14 @@
+/*
+ * Host stand-in of the emlib em_core.h, the emulator runs in one thread
+ * without interrupts.
+ */
+#ifndef EM_CORE_H
+#define EM_CORE_H
+
+#define CORE_DECLARE_IRQ_STATE  int irqState = 0
+#define CORE_ENTER_ATOMIC()     (void)irqState
+#define CORE_EXIT_ATOMIC()      (void)irqState
+#define CORE_ENTER_CRITICAL()   (void)irqState
+#define CORE_EXIT_CRITICAL()    (void)irqState
+
+#endif // EM_CORE_H
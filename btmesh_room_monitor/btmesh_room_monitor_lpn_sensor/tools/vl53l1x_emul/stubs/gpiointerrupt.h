@@ -0,0 +1,8 @@
+/*
+ * Host stand-in of the emlib gpiointerrupt.h, the emulator build polls the
+ * data ready over the emulated registers.
+ */
+#ifndef GPIOINTERRUPT_H
+#define GPIOINTERRUPT_H
+
+#endif // GPIOINTERRUPT_H
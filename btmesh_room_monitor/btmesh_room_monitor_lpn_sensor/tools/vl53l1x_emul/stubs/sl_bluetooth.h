@@ -0,0 +1,8 @@
+/*
+ * Host stand-in of the Bluetooth stack sl_bluetooth.h, not used by the
+ * emulator build.
+ */
+#ifndef SL_BLUETOOTH_H
+#define SL_BLUETOOTH_H
+
+#endif // SL_BLUETOOTH_H
@@ -0,0 +1,13 @@
+/*
+ * Host stand-in of the Gecko SDK sl_sleeptimer.h, one tick per millisecond
+ * of the emulator clock. Implemented in vl53l1x_emul_run.c.
+ */
+#ifndef SL_SLEEPTIMER_H
+#define SL_SLEEPTIMER_H
+
+#include <stdint.h>
+
+uint32_t sl_sleeptimer_get_tick_count(void);
+uint32_t sl_sleeptimer_ms_to_tick(uint16_t time_ms);
+
+#endif // SL_SLEEPTIMER_H
@@ -0,0 +1,21 @@
+/*
+ * Host stand-in of the Gecko SDK sl_status.h for the VL53L1X emulator build,
+ * only the status codes used by the sources built on the host.
+ */
+#ifndef SL_STATUS_H
+#define SL_STATUS_H
+
+#include <stdint.h>
+
+typedef uint32_t sl_status_t;
+
+#define SL_STATUS_OK                  ((sl_status_t)0x0000)
+#define SL_STATUS_FAIL                ((sl_status_t)0x0001)
+#define SL_STATUS_TIMEOUT             ((sl_status_t)0x0007)
+#define SL_STATUS_NOT_FOUND           ((sl_status_t)0x000C)
+#define SL_STATUS_TRANSMIT            ((sl_status_t)0x000F)
+#define SL_STATUS_ALLOCATION_FAILED   ((sl_status_t)0x0019)
+#define SL_STATUS_NO_MORE_RESOURCE    ((sl_status_t)0x001A)
+#define SL_STATUS_INVALID_PARAMETER   ((sl_status_t)0x0021)
+
+#endif // SL_STATUS_H
@@ -0,0 +1,181 @@
+/***************************************************************************//**
+ * @file vl53l1x_emul_run.c
+ * @brief Host run of the VL53L1X application on the emulator
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sl_sleeptimer.h"
+#include "vl53l1_platform_emul.h"
+#include "vl53l1x_app.h"
+
+/***************************************************************************//**
+ * @addtogroup vl53l1x_emul_run
+ * @brief  VL53L1X application run on the emulator.
+ * @details
+ *   Host program running vl53l1x_app.c and the people counting on the
+ *   register level emulator of vl53l1_platform_emul.c. Each sensor plays
+ *   back its own trace file, the first one is used for the missing ones:
+ *
+ *     make -C tools/vl53l1x_emul
+ *     ./vl53l1x_emul_run [-d duration_ms] trace.csv [trace_sensor1.csv ...]
+ *
+ *   The crossings are printed on stdout as "enter <n> leave <n>", the bus
+ *   and ranging counters on stderr. "make check" compares the result of
+ *   each trace of traces/ with its .expected file.
+ * @{
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+// Defines
+
+// Defaults of room_monitor_app.c
+#define MIN_DISTANCE              0
+#define MAX_DISTANCE              2700
+#define DISTANCE_THRESHOLD        1600
+#define TIMING_BUDGET             33
+
+#define BUS_FREQUENCY             400000
+#define DURATION_MS               12000 // run time without -d
+#define STEP_US                   2000  // MCU sleep between two polls
+#define HEALTH_PERIOD_MS          1000  // same as room_monitor_app.c
+
+// -----------------------------------------------------------------------------
+// Private variables
+
+static unsigned long enters;
+static unsigned long leaves;
+
+// -----------------------------------------------------------------------------
+// Public function definitions
+
+int main(int argc, char *argv[])
+{
+  uint32_t duration_ms = DURATION_MS;
+  uint32_t health_ms = 0;
+  uint32_t now_ms;
+  vl53l1_emul_stats_t stats;
+  int first = 1;
+  int i;
+
+  if ((argc > 2) && !strcmp(argv[1], "-d")) {
+    duration_ms = (uint32_t)strtoul(argv[2], NULL, 0);
+    first = 3;
+  }
+  if (first >= argc) {
+    fprintf(stderr,
+            "usage: %s [-d duration_ms] trace.csv [trace_sensor1.csv ...]\n",
+            argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  vl53l1_emul_init(BUS_FREQUENCY);
+  for (i = 0; i < VL53L1_EMUL_MAX_DEVICES; i++) {
+    const char *path = (first + i < argc) ? argv[first + i] : argv[first];
+
+    if (SL_STATUS_OK != vl53l1_emul_load_trace((uint8_t)i, path)) {
+      fprintf(stderr, "Can not load %s\n", path);
+      return EXIT_FAILURE;
+    }
+  }
+
+  vl53l1x_app_init(MIN_DISTANCE,
+                   MAX_DISTANCE,
+                   DISTANCE_THRESHOLD,
+                   TIMING_BUDGET);
+
+  for (;;) {
+    now_ms = sl_sleeptimer_get_tick_count();
+    if (now_ms >= duration_ms) {
+      break;
+    }
+    vl53l1_emul_advance_us(STEP_US);
+    // The first call starts the result read, the emulated transfer ends at
+    // once and the second call processes the result
+    vl53l1x_app_process_sampling_data();
+    vl53l1x_app_process_sampling_data();
+    if (now_ms - health_ms >= HEALTH_PERIOD_MS) {
+      health_ms = now_ms;
+      vl53l1x_app_check_health();
+    }
+  }
+
+  vl53l1_emul_get_stats(&stats);
+  fprintf(stderr,
+          "%lu ms: %lu transfers, %lu bytes, %lu us on the bus, "
+          "%lu rangings, %lu overruns\n",
+          (unsigned long)now_ms,
+          (unsigned long)stats.transfers,
+          (unsigned long)stats.bytes,
+          (unsigned long)stats.bus_time_us,
+          (unsigned long)stats.rangings,
+          (unsigned long)stats.overruns);
+  printf("enter %lu leave %lu\n", enters, leaves);
+
+  return EXIT_SUCCESS;
+}
+
+/***************************************************************************//**
+ * Count the crossings reported by the application.
+ ******************************************************************************/
+void vl53l1x_app_on_event(enum VL53L1X_APP_EVENT evt)
+{
+  if (VL53L1X_APP_EVENT_SOMEONE_ENTER == evt) {
+    enters++;
+  } else if (VL53L1X_APP_EVENT_SOMEONE_LEAVE == evt) {
+    leaves++;
+  }
+}
+
+/***************************************************************************//**
+ * Data ready interrupt, not used: the emulator build polls the sensors.
+ ******************************************************************************/
+void vl53l1x_app_on_data_ready(void)
+{
+}
+
+/***************************************************************************//**
+ * Sleeptimer of the multi-sensor event merge, on the emulator clock.
+ ******************************************************************************/
+uint32_t sl_sleeptimer_get_tick_count(void)
+{
+  return (uint32_t)(vl53l1_emul_get_time_us() / 1000);
+}
+
+uint32_t sl_sleeptimer_ms_to_tick(uint16_t time_ms)
+{
+  return time_ms;
+}
+
+/** @} (end group vl53l1x_emul_run) */
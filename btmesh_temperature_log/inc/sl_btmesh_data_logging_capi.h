@@ -162,10 +162,14 @@ typedef struct sl_btmesh_data_log_properties_s sl_btmesh_data_log_properties_t;
 #define SL_BTMESH_DATA_LOG_LENGTH_MAX (SL_BTMESH_STACK_SEND_LENGTH_MAX \
                                        - SL_BTMESH_DATA_LOG_INFO_LENGTH)
 
-/// Number of data index sent in one publication
+/// Number of whole records sent in one publication
+#define SL_BTMESH_DATA_LOG_SEG_RECORDS \
+      (SL_BTMESH_DATA_LOG_LENGTH_MAX/sizeof(sl_data_log_data_t))
+
+/// Number of segments needed to send x records
 #define SL_BTMESH_DATA_LOG_SEG_NUM(x) \
-      (((x)*sizeof(sl_data_log_data_t))/SL_BTMESH_DATA_LOG_LENGTH_MAX) \
-      + (((x)*sizeof(sl_data_log_data_t))%SL_BTMESH_DATA_LOG_LENGTH_MAX? 1 : 0)
+      (((x)/SL_BTMESH_DATA_LOG_SEG_RECORDS) \
+      + (((x)%SL_BTMESH_DATA_LOG_SEG_RECORDS)? 1 : 0))
 
 /// Frame header length
 #define SL_BTMESH_DATA_HEADER_LEN     sizeof(sl_data_frame_header_t)
@@ -173,6 +177,62 @@ typedef struct sl_btmesh_data_log_properties_s sl_btmesh_data_log_properties_t;
 /// Message Opcodes
 extern const uint8_t sl_btmesh_data_log_opcodes[];
 
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+/// Stack area below the stack pointer that is painted to find the peak usage
+#define SL_BTMESH_DATA_LOG_STATS_STACK_LEN    ((uint32_t)1024)
+/// Pattern of the painted stack area
+#define SL_BTMESH_DATA_LOG_STATS_STACK_FILL   ((uint32_t)0xA5A5A5A5)
+
+/// Statistics of the Log segmentation and reassembly path
+typedef struct sl_btmesh_data_log_stats {
+  uint32_t records;       ///< Number of records sent or received
+  uint32_t logs;          ///< Number of complete Logs sent or received
+  uint32_t segments;      ///< Number of segments sent or received
+  uint32_t bytes_copied;  ///< Number of Log bytes copied
+  uint32_t calls;         ///< Number of handler executions
+  uint64_t cycles;        ///< CPU cycles spent in the handler
+  uint32_t stack_peak;    ///< Peak stack usage of the handler in bytes
+}sl_btmesh_data_log_stats_t;
+
+/// Measurement state of one handler execution
+typedef struct sl_btmesh_data_log_probe {
+  uint32_t start_cycle;
+  uint32_t *stack_top;
+  uint32_t *stack_bottom;
+}sl_btmesh_data_log_probe_t;
+
+/***************************************************************************//**
+ * Start measuring a handler execution.
+ *
+ * @param[out] probe Pointer to the measurement state.
+ *
+ * Enables the DWT cycle counter and paints the unused stack area below the
+ * current stack pointer.
+ *
+ ******************************************************************************/
+void sli_btmesh_data_log_probe_start(sl_btmesh_data_log_probe_t *probe);
+
+/***************************************************************************//**
+ * Stop measuring a handler execution and accumulate the result.
+ *
+ * @param[in] probe Pointer to the measurement state.
+ * @param[out] stats Pointer to the statistics to be updated.
+ *
+ ******************************************************************************/
+void sli_btmesh_data_log_probe_stop(sl_btmesh_data_log_probe_t *probe,
+                                    sl_btmesh_data_log_stats_t *stats);
+
+/***************************************************************************//**
+ * Print the statistics with the derived records/sec and segments per Log.
+ *
+ * @param[in] name Name of the measured path.
+ * @param[in] stats Pointer to the statistics.
+ *
+ ******************************************************************************/
+void sl_btmesh_data_log_stats_print(const char *name,
+                                    const sl_btmesh_data_log_stats_t *stats);
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
+
 #endif // SL_BTMESH_DATA_LOGGING_CAPI_H
 
 #ifdef __cplusplus
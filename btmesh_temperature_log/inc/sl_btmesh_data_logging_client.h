@@ -142,6 +142,25 @@ sl_status_t sl_btmesh_data_log_client_reset_log(void);
  ******************************************************************************/
 uint8_t sl_btmesh_data_log_get_client_state(void);
 
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+/***************************************************************************//**
+ * Get the statistics of the Log receiving path.
+ *
+ * @param[out] stats Pointer to the statistics to be filled.
+ *
+ * @return SL_STATUS_OK if successful. Error code otherwise.
+ *
+ ******************************************************************************/
+sl_status_t sl_btmesh_data_log_client_get_stats(
+                      sl_btmesh_data_log_stats_t *stats);
+
+/***************************************************************************//**
+ * Reset the statistics of the Log receiving path.
+ *
+ ******************************************************************************/
+void sl_btmesh_data_log_client_reset_stats(void);
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
+
 #endif // SL_BTMESH_DATA_LOGGING_CLIENT_H
 
 #ifdef __cplusplus
@@ -45,6 +45,9 @@ extern "C" {
 /// Enable buffer roll over
 //#define SL_BTMESH_DATA_LOG_BUFF_ROLL_EN
 
+/// Enable the segmentation and reassembly statistics
+//#define SL_BTMESH_DATA_LOG_STATS_EN
+
 /// Timeout value in MS
 #define SL_BTMESH_DATA_LOG_TIMEOUT_MS_CFG_VAL       ((uint16_t)3000)
 /// Time delay value for send response in MS
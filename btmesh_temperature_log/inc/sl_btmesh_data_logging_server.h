@@ -82,6 +82,38 @@ sl_status_t sl_btmesh_data_log_reset(void);
  ******************************************************************************/
 uint8_t sl_btmesh_data_log_get_server_state(void);
 
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+/***************************************************************************//**
+ * Fill the Log with synthetic records.
+ *
+ * @param[in] count Number of records to be filled.
+ *
+ * The records contain a counting byte pattern, so the reassembled Log can be
+ * checked on the client side.
+ *
+ * @return SL_STATUS_OK if successful. Error code otherwise.
+ *
+ ******************************************************************************/
+sl_status_t sl_btmesh_data_log_fill(sl_data_log_index_t count);
+
+/***************************************************************************//**
+ * Get the statistics of the Log sending path.
+ *
+ * @param[out] stats Pointer to the statistics to be filled.
+ *
+ * @return SL_STATUS_OK if successful. Error code otherwise.
+ *
+ ******************************************************************************/
+sl_status_t sl_btmesh_data_log_server_get_stats(
+                      sl_btmesh_data_log_stats_t *stats);
+
+/***************************************************************************//**
+ * Reset the statistics of the Log sending path.
+ *
+ ******************************************************************************/
+void sl_btmesh_data_log_server_reset_stats(void);
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
+
 /***************************************************************************//**
  * Handle event of the Log server.
  *
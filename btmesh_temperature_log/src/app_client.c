@@ -287,6 +287,12 @@ void sl_btmesh_data_log_client_recv_complete_callback(void)
 {
   log_received_flag = true;
   app_log("Log received complete\r\n");
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+  sl_btmesh_data_log_stats_t stats;
+  if(SL_STATUS_OK == sl_btmesh_data_log_client_get_stats(&stats)){
+      sl_btmesh_data_log_stats_print("Log receive", &stats);
+  }
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
 }
 
 /***************************************************************************//**
@@ -307,6 +307,12 @@ void sl_btmesh_data_log_on_sample_callback(void)
 void sl_btmesh_data_log_complete_callback(void)
 {
   app_log("Log sent completely\r\n");
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+  sl_btmesh_data_log_stats_t stats;
+  if(SL_STATUS_OK == sl_btmesh_data_log_server_get_stats(&stats)){
+      sl_btmesh_data_log_stats_print("Log send", &stats);
+  }
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
 }
 
 /***************************************************************************//**
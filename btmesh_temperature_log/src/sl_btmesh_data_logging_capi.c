@@ -33,6 +33,14 @@ extern "C" {
 
 #include "sl_btmesh_data_logging_capi.h"
 
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+#include "em_device.h"
+#include "app_log.h"
+
+/// Lowest address of the stack, provided by the linker script
+extern uint32_t __StackLimit;
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
+
 /// Message Opcodes instance
 const uint8_t sl_btmesh_data_log_opcodes[SL_BTMESH_DATA_LOG_OPCODE_LENGTH] = {
     SL_BTMESH_DATA_LOG_MESSAGE_STATUS_ID,
@@ -44,6 +52,101 @@ const uint8_t sl_btmesh_data_log_opcodes[SL_BTMESH_DATA_LOG_OPCODE_LENGTH] = {
     SL_BTMESH_DATA_LOG_MESSAGE_TEMP_REQ_ID
 };
 
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+/***************************************************************************//**
+ * Start measuring a handler execution.
+ *
+ * @param[out] probe Pointer to the measurement state.
+ *
+ * Enables the DWT cycle counter and paints the unused stack area below the
+ * current stack pointer.
+ *
+ ******************************************************************************/
+void sli_btmesh_data_log_probe_start(sl_btmesh_data_log_probe_t *probe)
+{
+  uint32_t *ptr;
+
+  probe->stack_top = (uint32_t *)__get_MSP();
+  probe->stack_bottom = probe->stack_top
+                        - SL_BTMESH_DATA_LOG_STATS_STACK_LEN/sizeof(uint32_t);
+  if(probe->stack_bottom < &__StackLimit){
+      probe->stack_bottom = &__StackLimit;
+  }
+  // Keep a small guard for the frame of this function
+  for(ptr = probe->stack_bottom; ptr < (probe->stack_top - 8); ptr++){
+      *ptr = SL_BTMESH_DATA_LOG_STATS_STACK_FILL;
+  }
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  probe->start_cycle = DWT->CYCCNT;
+}
+
+/***************************************************************************//**
+ * Stop measuring a handler execution and accumulate the result.
+ *
+ * @param[in] probe Pointer to the measurement state.
+ * @param[out] stats Pointer to the statistics to be updated.
+ *
+ ******************************************************************************/
+void sli_btmesh_data_log_probe_stop(sl_btmesh_data_log_probe_t *probe,
+                                    sl_btmesh_data_log_stats_t *stats)
+{
+  uint32_t cycles = DWT->CYCCNT - probe->start_cycle;
+  uint32_t *ptr = probe->stack_bottom;
+  uint32_t depth;
+
+  // The first overwritten word is the deepest point reached by the handler
+  while((ptr < probe->stack_top)
+        && (SL_BTMESH_DATA_LOG_STATS_STACK_FILL == *ptr)){
+      ptr++;
+  }
+  depth = (uint32_t)(probe->stack_top - ptr) * sizeof(uint32_t);
+
+  stats->calls++;
+  stats->cycles += cycles;
+  if(depth > stats->stack_peak){
+      stats->stack_peak = depth;
+  }
+}
+
+/***************************************************************************//**
+ * Print the statistics with the derived records/sec and segments per Log.
+ *
+ * @param[in] name Name of the measured path.
+ * @param[in] stats Pointer to the statistics.
+ *
+ ******************************************************************************/
+void sl_btmesh_data_log_stats_print(const char *name,
+                                    const sl_btmesh_data_log_stats_t *stats)
+{
+  uint32_t records_per_sec = 0;
+  uint32_t segments_per_log = 0;
+
+  if(0 != stats->cycles){
+      records_per_sec = (uint32_t)(((uint64_t)stats->records
+                                    * SystemCoreClockGet()) / stats->cycles);
+  }
+  if(0 != stats->logs){
+      segments_per_log = stats->segments / stats->logs;
+  }
+
+  app_log("%s: %lu records, %lu logs, %lu segments, %lu bytes copied\r\n",
+          name,
+          (unsigned long)stats->records,
+          (unsigned long)stats->logs,
+          (unsigned long)stats->segments,
+          (unsigned long)stats->bytes_copied);
+  app_log("%s: %lu records/sec, %lu segments/log, %lu cycles/call, "
+          "%lu bytes peak stack\r\n",
+          name,
+          (unsigned long)records_per_sec,
+          (unsigned long)segments_per_log,
+          (unsigned long)(stats->calls ? (stats->cycles / stats->calls) : 0),
+          (unsigned long)stats->stack_peak);
+}
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
+
 #ifdef __cplusplus
 }
 #endif
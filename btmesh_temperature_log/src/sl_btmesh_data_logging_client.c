@@ -77,6 +77,11 @@ static uint8_t sli_recv_count;
 /// Used to store the received data
 static sl_data_log_data_t sli_data_received;
 
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+/// Statistics of the Log receiving path
+static sl_btmesh_data_log_stats_t sli_recv_stats;
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
+
 /***************************************************************************//**
  * Initialize the data log client.
  *
@@ -170,6 +175,11 @@ static sl_status_t sli_btmesh_data_log_receive_handler(sl_btmesh_msg_t *evt)
       }
       // Update new index
       sli_data_log_ptr->index = index + recv_len/sizeof(sl_data_log_data_t);
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+      sli_recv_stats.segments++;
+      sli_recv_stats.records += recv_len/sizeof(sl_data_log_data_t);
+      sli_recv_stats.bytes_copied += recv_len;
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
   } else { return SL_STATUS_FULL; }
 
   if(SL_BTMESH_DATA_LOG_LAST == frame->header.last){
@@ -187,6 +197,9 @@ static sl_status_t sli_btmesh_data_log_receive_handler(sl_btmesh_msg_t *evt)
           sli_data_log_ptr->dest_addr = log_evt->destination_address;
           sli_recv_status = SL_BTMESH_DATA_LOG_COMPLETE;
           sli_recv_count = frame->header.count;
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+          sli_recv_stats.logs++;
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
           // Execute complete callback
           sl_btmesh_data_log_client_recv_complete_callback();
       } else { // Duplicated data received
@@ -260,7 +273,16 @@ sl_status_t sl_btmesh_data_log_on_client_receive_event(
     switch(log_evt->opcode){
       case SL_BTMESH_DATA_LOG_MESSAGE_STATUS_ID:
         // Handle received data
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+        {
+          sl_btmesh_data_log_probe_t probe;
+          sli_btmesh_data_log_probe_start(&probe);
+          st = sli_btmesh_data_log_receive_handler(evt);
+          sli_btmesh_data_log_probe_stop(&probe, &sli_recv_stats);
+        }
+#else
         st = sli_btmesh_data_log_receive_handler(evt);
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
         #if defined(SL_BTMESH_DATA_LOG_RSP_ENABLE)
         if(SL_STATUS_OK == st){
           uint8_t tmp_buff[SL_BTMESH_DATA_LOG_PROP_LEN];
@@ -491,6 +513,36 @@ uint8_t sl_btmesh_data_log_get_client_state(void)
   return sli_recv_status;
 }
 
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+/***************************************************************************//**
+ * Get the statistics of the Log receiving path.
+ *
+ * @param[out] stats Pointer to the statistics to be filled.
+ *
+ * @return SL_STATUS_OK if successful. Error code otherwise.
+ *
+ ******************************************************************************/
+sl_status_t sl_btmesh_data_log_client_get_stats(
+                      sl_btmesh_data_log_stats_t *stats)
+{
+  if(NULL == stats){
+      return SL_STATUS_NULL_POINTER;
+  }
+  *stats = sli_recv_stats;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Reset the statistics of the Log receiving path.
+ *
+ ******************************************************************************/
+void sl_btmesh_data_log_client_reset_stats(void)
+{
+  memset(&sli_recv_stats, 0, sizeof(sli_recv_stats));
+}
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
+
 #ifdef __cplusplus
 }
 #endif
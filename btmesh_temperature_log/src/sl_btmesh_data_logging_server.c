@@ -58,6 +58,9 @@ static sl_status_t sli_btmesh_data_log_send(sl_data_frame_t *frame,
 /// Handle data transmission
 static sl_status_t sli_btmesh_data_log_send_handler(void);
 
+/// Send the next segment of the Log
+static sl_status_t sli_btmesh_data_log_send_segment(void);
+
 /// Timeout timer callback
 static void sli_btmesh_data_log_timeout_callback(
             sl_sleeptimer_timer_handle_t *handle,
@@ -152,6 +155,11 @@ static sl_sleeptimer_timer_handle_t sli_data_log_sample_timer;
 /// Timer for the log report
 static sl_sleeptimer_timer_handle_t sli_data_log_periodic_timer;
 
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+/// Statistics of the Log sending path
+static sl_btmesh_data_log_stats_t sli_send_stats;
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
+
 /***************************************************************************//**
  *
  * Functions implementation
@@ -459,7 +467,29 @@ sl_status_t sl_btmesh_data_log_step(void)
  * @return SL_STATUS_OK if successful. Error code otherwise.
  *
  ******************************************************************************/
-sl_status_t sli_btmesh_data_log_send_handler(void)
+static sl_status_t sli_btmesh_data_log_send_handler(void)
+{
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+  sl_status_t st;
+  sl_btmesh_data_log_probe_t probe;
+
+  sli_btmesh_data_log_probe_start(&probe);
+  st = sli_btmesh_data_log_send_segment();
+  sli_btmesh_data_log_probe_stop(&probe, &sli_send_stats);
+
+  return st;
+#else
+  return sli_btmesh_data_log_send_segment();
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
+}
+
+/***************************************************************************//**
+ * Send the next segment of the Log.
+ *
+ * @return SL_STATUS_OK if successful. Error code otherwise.
+ *
+ ******************************************************************************/
+static sl_status_t sli_btmesh_data_log_send_segment(void)
 {
   sl_status_t st;
   sl_data_log_length_t len;
@@ -483,7 +513,7 @@ sl_status_t sli_btmesh_data_log_send_handler(void)
           }
       }
       if(sli_send_count > 1){
-          len = SL_BTMESH_DATA_LOG_LENGTH_MAX
+          len = SL_BTMESH_DATA_LOG_SEG_RECORDS
                 * sizeof(sl_data_log_data_t);
 
           // Send segment
@@ -493,8 +523,13 @@ sl_status_t sli_btmesh_data_log_send_handler(void)
           st = sli_btmesh_data_log_send(&data_frame, len);
 
           if(SL_STATUS_OK == st){
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+              sli_send_stats.segments++;
+              sli_send_stats.records += SL_BTMESH_DATA_LOG_SEG_RECORDS;
+              sli_send_stats.bytes_copied += len;
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
               // Point to the next segment
-              sli_send_index += SL_BTMESH_DATA_LOG_LENGTH_MAX;
+              sli_send_index += SL_BTMESH_DATA_LOG_SEG_RECORDS;
               sli_send_count--;
           } else { // Send failed
               // Reset transmission
@@ -513,6 +548,12 @@ sl_status_t sli_btmesh_data_log_send_handler(void)
           data_frame.data = &(sli_data_log_inst.data[sli_send_index]);
           st = sli_btmesh_data_log_send(&data_frame, len);
           if(SL_STATUS_OK == st){
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+              sli_send_stats.segments++;
+              sli_send_stats.records += sli_data_log_inst.index
+                                        - sli_send_index;
+              sli_send_stats.bytes_copied += len;
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
               sli_send_count--;
           } else { // Send fail
               // Reset transmission
@@ -529,6 +570,9 @@ sl_status_t sli_btmesh_data_log_send_handler(void)
       sli_send_status = SL_BTMESH_DATA_LOG_IDLE;
       is_sending_started = false;
       sl_sleeptimer_stop_timer(&sli_data_log_timeout_timer);
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+      sli_send_stats.logs++;
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
       // Execute complete callback
       sl_btmesh_data_log_complete_callback();
       // Next sending ID
@@ -616,6 +660,67 @@ uint8_t sl_btmesh_data_log_get_server_state(void)
   return sli_send_status;
 }
 
+#if defined(SL_BTMESH_DATA_LOG_STATS_EN)
+/***************************************************************************//**
+ * Fill the Log with synthetic records.
+ *
+ * @param[in] count Number of records to be filled.
+ *
+ * The records contain a counting byte pattern, so the reassembled Log can be
+ * checked on the client side.
+ *
+ * @return SL_STATUS_OK if successful. Error code otherwise.
+ *
+ ******************************************************************************/
+sl_status_t sl_btmesh_data_log_fill(sl_data_log_index_t count)
+{
+  uint8_t *ptr = (uint8_t *)sli_data_log_inst.data;
+  size_t pos;
+
+  if(SL_BTMESH_DATA_LOG_BUSY == sli_send_status){
+      return SL_STATUS_BUSY;
+  }
+  if(count > SL_BTMESH_DATA_LOG_BUFF_SIZE_CFG_VAL){
+      return SL_STATUS_INVALID_RANGE;
+  }
+
+  for(pos = 0; pos < count*sizeof(sl_data_log_data_t); pos++){
+      ptr[pos] = (uint8_t)pos;
+  }
+  sli_data_log_inst.index = count;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Get the statistics of the Log sending path.
+ *
+ * @param[out] stats Pointer to the statistics to be filled.
+ *
+ * @return SL_STATUS_OK if successful. Error code otherwise.
+ *
+ ******************************************************************************/
+sl_status_t sl_btmesh_data_log_server_get_stats(
+                      sl_btmesh_data_log_stats_t *stats)
+{
+  if(NULL == stats){
+      return SL_STATUS_NULL_POINTER;
+  }
+  *stats = sli_send_stats;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Reset the statistics of the Log sending path.
+ *
+ ******************************************************************************/
+void sl_btmesh_data_log_server_reset_stats(void)
+{
+  memset(&sli_send_stats, 0, sizeof(sli_send_stats));
+}
+#endif // SL_BTMESH_DATA_LOG_STATS_EN
+
 /***************************************************************************//**
  * Handle event of the Log server.
  *
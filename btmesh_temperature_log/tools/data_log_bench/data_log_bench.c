@@ -0,0 +1,465 @@
+/***************************************************************************//**
+* @file data_log_bench.c
+* @brief Host benchmark of the Data Log segmentation and reassembly
+*******************************************************************************
+* # License
+* <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "em_device.h"
+#include "nvm3.h"
+#include "sl_sleeptimer.h"
+#include "sl_btmesh_data_logging_server.h"
+#include "sl_btmesh_data_logging_client.h"
+
+/// Number of times each Log is sent
+#define BENCH_REPEAT_DEFAULT    100
+
+/// Number of NVM3 objects kept in RAM
+#define BENCH_NVM3_OBJECTS      4
+/// Size of one NVM3 object
+#define BENCH_NVM3_OBJECT_LEN   32
+
+/// Message published by the server, handed to the client as received
+static union {
+  sl_btmesh_msg_t msg;
+  uint8_t raw[sizeof(sl_btmesh_msg_t) + SL_BTMESH_STACK_SEND_LENGTH_MAX];
+} bench_frame;
+/// A message is published and not yet received
+static bool bench_frame_ready;
+
+/// Log of the client
+static sl_data_log_data_t bench_recv_arr[SL_BTMESH_DATA_LOG_BUFF_SIZE_CFG_VAL];
+static sl_data_log_recv_t bench_recv_log = {
+  .data = bench_recv_arr
+};
+/// Logs received complete by the client
+static uint32_t bench_recv_complete;
+
+/// NVM3 objects of the server properties
+static struct {
+  bool valid;
+  size_t len;
+  uint8_t data[BENCH_NVM3_OBJECT_LEN];
+} bench_nvm3[BENCH_NVM3_OBJECTS];
+
+nvm3_Handle_t *nvm3_defaultHandle;
+CoreDebug_Type data_log_bench_core_debug;
+/// No stack limit on the host, the probes paint below the stack pointer
+uint32_t __StackLimit;
+
+/***************************************************************************//**
+ * Hand the published message over to the client.
+ *
+ * @return true if the client accepted the message or none was published.
+ *
+ ******************************************************************************/
+static bool bench_deliver(void)
+{
+  sl_status_t st;
+
+  if(!bench_frame_ready){
+      return true;
+  }
+  st = sl_btmesh_data_log_on_client_receive_event(&bench_frame.msg);
+  bench_frame.msg.data.evt_vendor_model_receive.payload.len = 0;
+  bench_frame_ready = false;
+  if(SL_STATUS_OK != st){
+      printf("Receive failed: 0x%04x\n", (unsigned)st);
+      return false;
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * Send a Log of the given number of records to the client.
+ *
+ * @param[in] count Number of records of the Log.
+ *
+ * @return true if the client received the same Log.
+ *
+ ******************************************************************************/
+static bool bench_send_log(sl_data_log_index_t count)
+{
+  uint32_t complete = bench_recv_complete;
+  const uint8_t *recv_data = (const uint8_t *)bench_recv_log.data;
+  size_t pos;
+
+  if(SL_STATUS_OK != sl_btmesh_data_log_fill(count)){
+      printf("Fill of %u records failed\n", (unsigned)count);
+      return false;
+  }
+  if(SL_STATUS_OK != sl_btmesh_data_log_server_send_status()){
+      printf("Send of %u records failed\n", (unsigned)count);
+      return false;
+  }
+  if(!bench_deliver()){
+      return false;
+  }
+  // Each step sends one segment, the last step completes the Log
+  while(sl_btmesh_data_log_is_started_sending()){
+      if((SL_STATUS_OK != sl_btmesh_data_log_step()) || !bench_deliver()){
+          return false;
+      }
+  }
+
+  if((bench_recv_complete != complete + 1)
+     || (bench_recv_log.index != count)){
+      printf("Log of %u records received as %u records\n",
+             (unsigned)count,
+             (unsigned)bench_recv_log.index);
+      return false;
+  }
+  // Counting byte pattern of sl_btmesh_data_log_fill()
+  for(pos = 0; pos < count*sizeof(sl_data_log_data_t); pos++){
+      if((uint8_t)pos != recv_data[pos]){
+          printf("Log of %u records differs at byte %u\n",
+                 (unsigned)count,
+                 (unsigned)pos);
+          return false;
+      }
+  }
+  return (SL_STATUS_OK == sl_btmesh_data_log_client_reset_log());
+}
+
+/***************************************************************************//**
+ * Send a Log repeatedly and print the statistics of both paths.
+ *
+ * @param[in] count Number of records of the Log.
+ * @param[in] repeat Number of times the Log is sent.
+ *
+ * @return true if every Log was received and the statistics add up.
+ *
+ ******************************************************************************/
+static bool bench_run(sl_data_log_index_t count, uint32_t repeat)
+{
+  sl_btmesh_data_log_stats_t send_stats;
+  sl_btmesh_data_log_stats_t recv_stats;
+  uint32_t segments = SL_BTMESH_DATA_LOG_SEG_NUM(count) * repeat;
+  uint32_t i;
+
+  sl_btmesh_data_log_server_reset_stats();
+  sl_btmesh_data_log_client_reset_stats();
+  for(i = 0; i < repeat; i++){
+      if(!bench_send_log(count)){
+          return false;
+      }
+  }
+  (void)sl_btmesh_data_log_server_get_stats(&send_stats);
+  (void)sl_btmesh_data_log_client_get_stats(&recv_stats);
+
+  printf("\nLog of %u records, sent %lu times\n",
+         (unsigned)count,
+         (unsigned long)repeat);
+  sl_btmesh_data_log_stats_print("send", &send_stats);
+  sl_btmesh_data_log_stats_print("receive", &recv_stats);
+
+  if((send_stats.logs != repeat) || (recv_stats.logs != repeat)
+     || (send_stats.segments != segments)
+     || (recv_stats.segments != segments)
+     || (send_stats.records != count*repeat)
+     || (recv_stats.records != count*repeat)
+     || (send_stats.bytes_copied != recv_stats.bytes_copied)){
+      printf("Statistics do not add up, %lu segments expected\n",
+             (unsigned long)segments);
+      return false;
+  }
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  const sl_data_log_index_t sizes[] = {
+    1,
+    SL_BTMESH_DATA_LOG_SEG_RECORDS,
+    SL_BTMESH_DATA_LOG_SEG_RECORDS + 1,
+    100,
+    SL_BTMESH_DATA_LOG_BUFF_SIZE_CFG_VAL
+  };
+  uint32_t repeat = BENCH_REPEAT_DEFAULT;
+  bool ok = true;
+  size_t i;
+
+  if(argc > 1){
+      repeat = (uint32_t)strtoul(argv[1], NULL, 0);
+  }
+  if((argc > 2) || (0 == repeat)){
+      fprintf(stderr, "usage: %s [repeat]\n", argv[0]);
+      return EXIT_FAILURE;
+  }
+
+  if((SL_STATUS_OK != sl_btmesh_data_log_server_init())
+     || (SL_STATUS_OK != sl_btmesh_data_log_client_init(&bench_recv_log))){
+      printf("Init failed\n");
+      return EXIT_FAILURE;
+  }
+
+  printf("Record: %s, %u bytes, %u records per segment\n",
+         DATA_LOG_BENCH_RECORD_NAME,
+         (unsigned)sizeof(sl_data_log_data_t),
+         (unsigned)SL_BTMESH_DATA_LOG_SEG_RECORDS);
+  for(i = 0; ok && (i < sizeof(sizes)/sizeof(sizes[0])); i++){
+      ok = bench_run(sizes[i], repeat);
+  }
+  printf("\n%s\n", ok ? "PASS" : "FAIL");
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/***************************************************************************//**
+ * Log receive complete callback function.
+ *
+ ******************************************************************************/
+void sl_btmesh_data_log_client_recv_complete_callback(void)
+{
+  bench_recv_complete++;
+}
+
+/***************************************************************************//**
+ *
+ * Host implementation of the stack, timer, NVM3 and core APIs
+ *
+ ******************************************************************************/
+sl_status_t sl_btmesh_vendor_model_init(uint16_t elem_index,
+                                        uint16_t vendor_id,
+                                        uint16_t model_id,
+                                        uint8_t publish,
+                                        size_t opcodes_len,
+                                        const uint8_t *opcodes)
+{
+  (void)elem_index;
+  (void)vendor_id;
+  (void)model_id;
+  (void)publish;
+  (void)opcodes_len;
+  (void)opcodes;
+  return SL_STATUS_OK;
+}
+
+sl_status_t sl_btmesh_vendor_model_deinit(uint16_t elem_index,
+                                          uint16_t vendor_id,
+                                          uint16_t model_id)
+{
+  (void)elem_index;
+  (void)vendor_id;
+  (void)model_id;
+  return SL_STATUS_OK;
+}
+
+// The parts set before the final one make up a single message
+sl_status_t sl_btmesh_vendor_model_set_publication(uint16_t elem_index,
+                                                   uint16_t vendor_id,
+                                                   uint16_t model_id,
+                                                   uint8_t opcode,
+                                                   uint8_t final,
+                                                   size_t payload_len,
+                                                   const uint8_t *payload)
+{
+  sl_btmesh_evt_vendor_model_receive_t *evt =
+      &bench_frame.msg.data.evt_vendor_model_receive;
+
+  (void)model_id;
+  if(bench_frame_ready
+     || (evt->payload.len + payload_len > SL_BTMESH_STACK_SEND_LENGTH_MAX)){
+      return SL_STATUS_INVALID_RANGE;
+  }
+  memcpy(&evt->payload.data[evt->payload.len], payload, payload_len);
+  evt->payload.len += (uint8_t)payload_len;
+  evt->elem_index = elem_index;
+  evt->vendor_id = vendor_id;
+  evt->model_id = SL_BTMESH_DATA_LOG_MODEL_CLIENT_ID;
+  evt->opcode = opcode;
+  evt->final = final;
+  return SL_STATUS_OK;
+}
+
+sl_status_t sl_btmesh_vendor_model_publish(uint16_t elem_index,
+                                           uint16_t vendor_id,
+                                           uint16_t model_id)
+{
+  sl_btmesh_evt_vendor_model_receive_t *evt =
+      &bench_frame.msg.data.evt_vendor_model_receive;
+
+  (void)elem_index;
+  (void)vendor_id;
+  (void)model_id;
+  if(!evt->final){
+      return SL_STATUS_FAIL;
+  }
+  bench_frame_ready = true;
+  return SL_STATUS_OK;
+}
+
+sl_status_t sl_btmesh_vendor_model_send(uint16_t destination_address,
+                                        int8_t va_index,
+                                        uint16_t appkey_index,
+                                        uint16_t elem_index,
+                                        uint16_t vendor_id,
+                                        uint16_t model_id,
+                                        uint8_t nonrelayed,
+                                        uint8_t opcode,
+                                        uint8_t final,
+                                        size_t payload_len,
+                                        const uint8_t *payload)
+{
+  (void)destination_address;
+  (void)va_index;
+  (void)appkey_index;
+  (void)elem_index;
+  (void)vendor_id;
+  (void)model_id;
+  (void)nonrelayed;
+  (void)opcode;
+  (void)final;
+  (void)payload_len;
+  (void)payload;
+  return SL_STATUS_OK;
+}
+
+sl_status_t sl_sleeptimer_start_timer_ms(
+  sl_sleeptimer_timer_handle_t *handle, uint32_t timeout_ms,
+  sl_sleeptimer_timer_callback_t callback, void *callback_data,
+  uint8_t priority, uint16_t option_flags)
+{
+  (void)timeout_ms;
+  (void)callback;
+  (void)callback_data;
+  (void)priority;
+  (void)option_flags;
+  handle->running = true;
+  return SL_STATUS_OK;
+}
+
+sl_status_t sl_sleeptimer_restart_timer_ms(
+  sl_sleeptimer_timer_handle_t *handle, uint32_t timeout_ms,
+  sl_sleeptimer_timer_callback_t callback, void *callback_data,
+  uint8_t priority, uint16_t option_flags)
+{
+  return sl_sleeptimer_start_timer_ms(handle, timeout_ms, callback,
+                                      callback_data, priority, option_flags);
+}
+
+sl_status_t sl_sleeptimer_start_periodic_timer_ms(
+  sl_sleeptimer_timer_handle_t *handle, uint32_t timeout_ms,
+  sl_sleeptimer_timer_callback_t callback, void *callback_data,
+  uint8_t priority, uint16_t option_flags)
+{
+  return sl_sleeptimer_start_timer_ms(handle, timeout_ms, callback,
+                                      callback_data, priority, option_flags);
+}
+
+sl_status_t sl_sleeptimer_restart_periodic_timer_ms(
+  sl_sleeptimer_timer_handle_t *handle, uint32_t timeout_ms,
+  sl_sleeptimer_timer_callback_t callback, void *callback_data,
+  uint8_t priority, uint16_t option_flags)
+{
+  return sl_sleeptimer_start_timer_ms(handle, timeout_ms, callback,
+                                      callback_data, priority, option_flags);
+}
+
+sl_status_t sl_sleeptimer_stop_timer(sl_sleeptimer_timer_handle_t *handle)
+{
+  handle->running = false;
+  return SL_STATUS_OK;
+}
+
+sl_status_t sl_sleeptimer_is_timer_running(
+  sl_sleeptimer_timer_handle_t *handle, bool *running)
+{
+  *running = handle->running;
+  return SL_STATUS_OK;
+}
+
+Ecode_t nvm3_readData(nvm3_Handle_t *h, nvm3_ObjectKey_t key,
+                      void *value, size_t len)
+{
+  (void)h;
+  if((key >= BENCH_NVM3_OBJECTS) || !bench_nvm3[key].valid
+     || (len != bench_nvm3[key].len)){
+      return ECODE_NVM3_ERR_KEY_NOT_FOUND;
+  }
+  memcpy(value, bench_nvm3[key].data, len);
+  return ECODE_NVM3_OK;
+}
+
+Ecode_t nvm3_writeData(nvm3_Handle_t *h, nvm3_ObjectKey_t key,
+                       const void *value, size_t len)
+{
+  (void)h;
+  if((key >= BENCH_NVM3_OBJECTS) || (len > BENCH_NVM3_OBJECT_LEN)){
+      return ECODE_NVM3_ERR_KEY_NOT_FOUND;
+  }
+  memcpy(bench_nvm3[key].data, value, len);
+  bench_nvm3[key].len = len;
+  bench_nvm3[key].valid = true;
+  return ECODE_NVM3_OK;
+}
+
+Ecode_t nvm3_getObjectInfo(nvm3_Handle_t *h, nvm3_ObjectKey_t key,
+                           uint32_t *type, size_t *len)
+{
+  (void)h;
+  if((key >= BENCH_NVM3_OBJECTS) || !bench_nvm3[key].valid){
+      return ECODE_NVM3_ERR_KEY_NOT_FOUND;
+  }
+  *type = NVM3_OBJECTTYPE_DATA;
+  *len = bench_nvm3[key].len;
+  return ECODE_NVM3_OK;
+}
+
+Ecode_t nvm3_deleteObject(nvm3_Handle_t *h, nvm3_ObjectKey_t key)
+{
+  (void)h;
+  if(key < BENCH_NVM3_OBJECTS){
+      bench_nvm3[key].valid = false;
+  }
+  return ECODE_NVM3_OK;
+}
+
+DWT_Type *data_log_bench_dwt(void)
+{
+  static DWT_Type dwt;
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  dwt.CYCCNT = (uint32_t)((uint64_t)now.tv_sec * 1000000000u
+                          + (uint64_t)now.tv_nsec);
+  return &dwt;
+}
+
+uint32_t SystemCoreClockGet(void)
+{
+  // One DWT count per nanosecond
+  return 1000000000u;
+}
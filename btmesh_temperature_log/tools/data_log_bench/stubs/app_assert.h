@@ -0,0 +1,20 @@
+/*
+ * Host stand-in of the Gecko SDK app_assert.h, a failed assertion ends the
+ * benchmark with an error.
+ */
+#ifndef APP_ASSERT_H
+#define APP_ASSERT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define app_assert(expr, ...)                                         \
+  do {                                                                \
+    if (!(expr)) {                                                    \
+      fprintf(stderr, "Assertion '%s' failed at %s:%d\n",             \
+              #expr, __FILE__, __LINE__);                             \
+      exit(EXIT_FAILURE);                                             \
+    }                                                                 \
+  } while (0)
+
+#endif // APP_ASSERT_H
@@ -0,0 +1,11 @@
+/*
+ * Host stand-in of the Gecko SDK app_log.h, the logs go to stdout.
+ */
+#ifndef APP_LOG_H
+#define APP_LOG_H
+
+#include <stdio.h>
+
+#define app_log(...)    printf(__VA_ARGS__)
+
+#endif // APP_LOG_H
@@ -0,0 +1,13 @@
+/*
+ * Host stand-in of the emlib em_common.h.
+ */
+#ifndef EM_COMMON_H
+#define EM_COMMON_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SL_WEAK __attribute__((weak))
+#define __STATIC_INLINE static inline
+
+#endif // EM_COMMON_H
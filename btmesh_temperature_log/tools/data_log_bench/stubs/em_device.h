@@ -0,0 +1,43 @@
+/*
+ * Host stand-in of the device header for the cycle and stack probes of the
+ * data log statistics. The DWT cycle counter counts nanoseconds of the host
+ * monotonic clock, so SystemCoreClockGet() returns 1 GHz, and __get_MSP()
+ * reads the host stack pointer. Implemented in data_log_bench.c.
+ */
+#ifndef EM_DEVICE_H
+#define EM_DEVICE_H
+
+#include <stdint.h>
+
+typedef struct {
+  uint32_t CTRL;
+  uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+  uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk        (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk    (1UL << 24)
+
+// Each access to DWT reloads CYCCNT from the host clock
+#define DWT                           (data_log_bench_dwt())
+#define CoreDebug                     (&data_log_bench_core_debug)
+
+#if defined(__x86_64__)
+#define __get_MSP()                                        \
+  ({ uintptr_t sp; __asm__ volatile ("mov %%rsp, %0" : "=r" (sp)); sp; })
+#elif defined(__aarch64__)
+#define __get_MSP()                                        \
+  ({ uintptr_t sp; __asm__ volatile ("mov %0, sp" : "=r" (sp)); sp; })
+#else
+#define __get_MSP()   ((uintptr_t)__builtin_frame_address(0))
+#endif
+
+extern CoreDebug_Type data_log_bench_core_debug;
+
+DWT_Type *data_log_bench_dwt(void);
+uint32_t SystemCoreClockGet(void);
+
+#endif // EM_DEVICE_H
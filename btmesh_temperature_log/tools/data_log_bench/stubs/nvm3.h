@@ -0,0 +1,31 @@
+/*
+ * Host stand-in of the Gecko SDK nvm3.h, one RAM object per key.
+ * Implemented in data_log_bench.c.
+ */
+#ifndef NVM3_H
+#define NVM3_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t Ecode_t;
+typedef uint32_t nvm3_ObjectKey_t;
+typedef struct nvm3_Handle nvm3_Handle_t;
+
+#define ECODE_NVM3_OK                 ((Ecode_t)0x0000)
+#define ECODE_NVM3_ERR_KEY_NOT_FOUND  ((Ecode_t)0xE000C)
+
+#define NVM3_OBJECTTYPE_DATA          0
+#define NVM3_OBJECTTYPE_COUNTER       1
+
+extern nvm3_Handle_t *nvm3_defaultHandle;
+
+Ecode_t nvm3_readData(nvm3_Handle_t *h, nvm3_ObjectKey_t key,
+                      void *value, size_t len);
+Ecode_t nvm3_writeData(nvm3_Handle_t *h, nvm3_ObjectKey_t key,
+                       const void *value, size_t len);
+Ecode_t nvm3_getObjectInfo(nvm3_Handle_t *h, nvm3_ObjectKey_t key,
+                           uint32_t *type, size_t *len);
+Ecode_t nvm3_deleteObject(nvm3_Handle_t *h, nvm3_ObjectKey_t key);
+
+#endif // NVM3_H
@@ -0,0 +1,7 @@
+/*
+ * Host stand-in of the Gecko SDK nvm3_hal_flash.h, nothing is used.
+ */
+#ifndef NVM3_HAL_FLASH_H
+#define NVM3_HAL_FLASH_H
+
+#endif // NVM3_HAL_FLASH_H
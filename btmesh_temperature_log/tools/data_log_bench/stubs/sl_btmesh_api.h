@@ -0,0 +1,74 @@
+/*
+ * Host stand-in of the Bluetooth mesh sl_btmesh_api.h, only the vendor model
+ * event and commands used by the data log. The commands are implemented in
+ * data_log_bench.c, which hands each published message to the client.
+ */
+#ifndef SL_BTMESH_API_H
+#define SL_BTMESH_API_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "em_common.h"
+#include "sl_status.h"
+
+#define PACKSTRUCT(decl) decl __attribute__((__packed__))
+
+typedef struct {
+  uint8_t len;
+  uint8_t data[];
+} uint8array;
+
+typedef struct sl_btmesh_evt_vendor_model_receive_s {
+  uint16_t destination_address;
+  uint16_t elem_index;
+  uint16_t appkey_index;
+  uint8_t nonrelayed;
+  uint16_t source_address;
+  int8_t va_index;
+  uint16_t vendor_id;
+  uint16_t model_id;
+  uint8_t opcode;
+  uint8_t final;
+  uint8array payload;
+} sl_btmesh_evt_vendor_model_receive_t;
+
+typedef struct {
+  uint32_t header;
+  union {
+    sl_btmesh_evt_vendor_model_receive_t evt_vendor_model_receive;
+  } data;
+} sl_btmesh_msg_t;
+
+sl_status_t sl_btmesh_vendor_model_init(uint16_t elem_index,
+                                        uint16_t vendor_id,
+                                        uint16_t model_id,
+                                        uint8_t publish,
+                                        size_t opcodes_len,
+                                        const uint8_t *opcodes);
+sl_status_t sl_btmesh_vendor_model_deinit(uint16_t elem_index,
+                                          uint16_t vendor_id,
+                                          uint16_t model_id);
+sl_status_t sl_btmesh_vendor_model_set_publication(uint16_t elem_index,
+                                                   uint16_t vendor_id,
+                                                   uint16_t model_id,
+                                                   uint8_t opcode,
+                                                   uint8_t final,
+                                                   size_t payload_len,
+                                                   const uint8_t *payload);
+sl_status_t sl_btmesh_vendor_model_publish(uint16_t elem_index,
+                                           uint16_t vendor_id,
+                                           uint16_t model_id);
+sl_status_t sl_btmesh_vendor_model_send(uint16_t destination_address,
+                                        int8_t va_index,
+                                        uint16_t appkey_index,
+                                        uint16_t elem_index,
+                                        uint16_t vendor_id,
+                                        uint16_t model_id,
+                                        uint8_t nonrelayed,
+                                        uint8_t opcode,
+                                        uint8_t final,
+                                        size_t payload_len,
+                                        const uint8_t *payload);
+
+#endif // SL_BTMESH_API_H
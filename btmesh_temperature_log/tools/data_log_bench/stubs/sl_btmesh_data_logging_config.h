@@ -0,0 +1,74 @@
+/*
+ * Data log configuration of the benchmark, used instead of
+ * inc/sl_btmesh_data_logging_config.h: same timings, the statistics
+ * enabled, a larger Log and the record type picked by
+ * DATA_LOG_BENCH_RECORD. Keep the timings in step with the project file.
+ */
+#ifndef SL_BTMESH_DATA_LOGGING_CONFIG_H
+#define SL_BTMESH_DATA_LOGGING_CONFIG_H
+
+#include "sl_btmesh_device_properties.h"
+
+/// The Data Log buffer size
+#define SL_BTMESH_DATA_LOG_BUFF_SIZE_CFG_VAL  ((size_t)1000)
+
+/// Default Main element
+#define SL_BTMESH_DATA_LOG_ELEMENT_CFG_VAL    ((uint16_t)0)
+
+/// Enable the segmentation and reassembly statistics
+#define SL_BTMESH_DATA_LOG_STATS_EN
+
+/// Timeout value in MS
+#define SL_BTMESH_DATA_LOG_TIMEOUT_MS_CFG_VAL       ((uint16_t)3000)
+/// Time delay value for send response in MS
+#define SL_BTMESH_DATA_LOG_RESP_MS_CFG_VAL          ((uint16_t)10)
+/// Send delay timer value in MS
+#define SL_BTMESH_DATA_LOG_SEND_DELAY_MS_CFG_VAL    ((uint16_t)10)
+
+/// Sample rate in MS
+#define SL_BTMESH_DATA_LOG_SAMPLE_RATE_MS_CFG_VAL   ((uint16_t)1000)
+/// Log period in MS
+#define SL_BTMESH_DATA_LOG_PERIOD_MS_CFG_VAL        ((uint16_t)10000)
+/// Threshold value
+#define SL_BTMESH_DATA_LOG_THESHOLD_CFG_VAL  ((sl_btmesh_data_log_threshold_t)0)
+
+#ifndef DATA_LOG_BENCH_RECORD
+#define DATA_LOG_BENCH_RECORD   0
+#endif
+
+/// The logging data type
+#if (DATA_LOG_BENCH_RECORD == 0)
+// Record of the application, 2 bytes
+#define DATA_LOG_BENCH_RECORD_NAME  "temperature, humidity"
+typedef struct {
+  temperature_8_t temp;
+  percentage_8_t  humid;
+}sl_data_log_data_t;
+#elif (DATA_LOG_BENCH_RECORD == 1)
+// 3 bytes, 245 is not a multiple of the record size
+#define DATA_LOG_BENCH_RECORD_NAME  "temperature, humidity, flags"
+typedef struct {
+  temperature_8_t temp;
+  percentage_8_t  humid;
+  uint8_t         flags;
+}sl_data_log_data_t;
+#elif (DATA_LOG_BENCH_RECORD == 2)
+// 8 bytes, time stamped
+#define DATA_LOG_BENCH_RECORD_NAME  "time, temperature, humidity"
+typedef struct {
+  uint32_t time;
+  int16_t  temp;
+  uint16_t humid;
+}sl_data_log_data_t;
+#elif (DATA_LOG_BENCH_RECORD == 3)
+// 20 bytes, one time stamp for 8 samples
+#define DATA_LOG_BENCH_RECORD_NAME  "time, 8 temperatures"
+typedef struct {
+  uint32_t time;
+  int16_t  temp[8];
+}sl_data_log_data_t;
+#else
+#error "Unknown DATA_LOG_BENCH_RECORD"
+#endif
+
+#endif // SL_BTMESH_DATA_LOGGING_CONFIG_H
@@ -0,0 +1,13 @@
+/*
+ * Host stand-in of the Bluetooth mesh sl_btmesh_device_properties.h, only
+ * the property types of the logged records.
+ */
+#ifndef SL_BTMESH_DEVICE_PROPERTIES_H
+#define SL_BTMESH_DEVICE_PROPERTIES_H
+
+#include <stdint.h>
+
+typedef int8_t temperature_8_t;
+typedef uint8_t percentage_8_t;
+
+#endif // SL_BTMESH_DEVICE_PROPERTIES_H
@@ -0,0 +1,40 @@
+/*
+ * Host stand-in of the Gecko SDK sl_sleeptimer.h. The timers only record
+ * that they run and never expire: the benchmark delivers every segment at
+ * once, long before the Log timeout. Implemented in data_log_bench.c.
+ */
+#ifndef SL_SLEEPTIMER_H
+#define SL_SLEEPTIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sl_status.h"
+
+typedef struct sl_sleeptimer_timer_handle {
+  bool running;
+} sl_sleeptimer_timer_handle_t;
+
+typedef void (*sl_sleeptimer_timer_callback_t)(
+  sl_sleeptimer_timer_handle_t *handle, void *data);
+
+sl_status_t sl_sleeptimer_start_timer_ms(
+  sl_sleeptimer_timer_handle_t *handle, uint32_t timeout_ms,
+  sl_sleeptimer_timer_callback_t callback, void *callback_data,
+  uint8_t priority, uint16_t option_flags);
+sl_status_t sl_sleeptimer_restart_timer_ms(
+  sl_sleeptimer_timer_handle_t *handle, uint32_t timeout_ms,
+  sl_sleeptimer_timer_callback_t callback, void *callback_data,
+  uint8_t priority, uint16_t option_flags);
+sl_status_t sl_sleeptimer_start_periodic_timer_ms(
+  sl_sleeptimer_timer_handle_t *handle, uint32_t timeout_ms,
+  sl_sleeptimer_timer_callback_t callback, void *callback_data,
+  uint8_t priority, uint16_t option_flags);
+sl_status_t sl_sleeptimer_restart_periodic_timer_ms(
+  sl_sleeptimer_timer_handle_t *handle, uint32_t timeout_ms,
+  sl_sleeptimer_timer_callback_t callback, void *callback_data,
+  uint8_t priority, uint16_t option_flags);
+sl_status_t sl_sleeptimer_stop_timer(sl_sleeptimer_timer_handle_t *handle);
+sl_status_t sl_sleeptimer_is_timer_running(
+  sl_sleeptimer_timer_handle_t *handle, bool *running);
+
+#endif // SL_SLEEPTIMER_H
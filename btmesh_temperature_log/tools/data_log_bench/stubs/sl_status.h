@@ -0,0 +1,22 @@
+/*
+ * Host stand-in of the Gecko SDK sl_status.h for the data log benchmark,
+ * only the status codes used by the sources built on the host.
+ */
+#ifndef SL_STATUS_H
+#define SL_STATUS_H
+
+#include <stdint.h>
+
+typedef uint32_t sl_status_t;
+
+#define SL_STATUS_OK                  ((sl_status_t)0x0000)
+#define SL_STATUS_FAIL                ((sl_status_t)0x0001)
+#define SL_STATUS_BUSY                ((sl_status_t)0x0004)
+#define SL_STATUS_NOT_INITIALIZED     ((sl_status_t)0x0011)
+#define SL_STATUS_ALLOCATION_FAILED   ((sl_status_t)0x0019)
+#define SL_STATUS_EMPTY               ((sl_status_t)0x001B)
+#define SL_STATUS_FULL                ((sl_status_t)0x001C)
+#define SL_STATUS_NULL_POINTER        ((sl_status_t)0x0022)
+#define SL_STATUS_INVALID_RANGE       ((sl_status_t)0x0028)
+
+#endif // SL_STATUS_H